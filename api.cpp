@@ -0,0 +1,186 @@
+/*
+ * Deep Becky 0.2 - UCI Chess Engine
+ * Copyright (C) 2025-2026 Diogo de Oliveira Almeida
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ */
+
+// Implementação da API embutível (deepbecky.h / deepbecky_c.h) sobre o núcleo.
+#define DEEPBECKY_BUILD
+#include "deepbecky.h"
+#include "deepbecky_c.h"
+#include "engine.h"
+
+namespace deepbecky {
+
+// score interno -> (mate?, cp ou lances até o mate)
+static void toScore(int sc, bool& mate, int& out){
+    mate = abs(sc) >= MATE_IN_MAX;
+    if(sc >= MATE_IN_MAX)       out = (MATE_SCORE - sc + 1)/2;
+    else if(sc <= -MATE_IN_MAX) out = -(MATE_SCORE + sc)/2;
+    else                        out = sc;
+}
+
+// stop() liga o halt só com uma busca em andamento; a engine nunca o zera,
+// então um stop logo no começo da busca não se perde.
+struct Engine::Halt {
+    mutex mx;
+    bool active = false;
+    atomic<bool> flag{false};
+};
+
+Engine::Engine(size_t hashMB) : e(make_unique<DeepBeckyEngine>(hashMB)), halt(make_unique<Halt>()) {
+    e->quiet_info = true;
+    e->own_book = false; // quem embute normalmente quer análise, não livro
+    e->halt = &halt->flag;
+}
+Engine::~Engine() = default;
+
+bool Engine::setPosition(const string& fen, const vector<string>& moves){
+    if(e->setPosition(fen, moves) != moves.size()) return false;
+    int wk=0, bk=0;
+    for(int y=0;y<8;y++) for(int x=0;x<8;x++){ wk += e->b[y][x]==WKING; bk += e->b[y][x]==BKING; }
+    return wk==1 && bk==1;
+}
+
+Result Engine::search(const Limits& l, const InfoCallback& onInfo){
+    SearchLimits lim;
+    lim.depth = l.depth;
+    lim.movetime = l.movetime_ms;
+    lim.nodes = l.nodes;
+    lim.wtime = l.wtime_ms; lim.btime = l.btime_ms;
+    lim.winc = l.winc_ms;   lim.binc = l.binc_ms;
+    lim.mate = l.mate;
+    lim.searchmoves = l.searchmoves;
+    lim.infinite = l.infinite || (l.depth<=0 && l.movetime_ms<0 && l.nodes<=0 && l.wtime_ms<0 && l.btime_ms<0 && l.mate<=0);
+    e->multi_pv = max(1, min(MAX_MULTIPV, l.multipv));
+
+    Result r;
+    e->on_info = [&](int d, int k, const DeepBeckyEngine::RootMove& rm, long long ms){
+        r.depth = d;
+        if(!onInfo) return;
+        Info i;
+        i.depth = d; i.multipv = k;
+        toScore(rm.score!=-INF_SCORE? rm.score : rm.prev_score, i.mate, i.score);
+        i.nodes = e->nodes; i.time_ms = ms;
+        i.nps = ms>0? e->nodes*1000/ms : 0;
+        for(const auto& m: rm.pv) i.pv.push_back(e->moveToUCI(m));
+        onInfo(i);
+    };
+
+    { lock_guard<mutex> lk(halt->mx); halt->flag = false; halt->active = true; }
+    auto t0 = chrono::high_resolution_clock::now();
+    if(e->generateLegal().empty()){
+        r.bestmove = "0000";
+        r.mate = e->inCheck(e->white_to_move);
+        r.score = 0;
+    }else{
+        Move bm = e->go(lim);
+        r.bestmove = e->moveToUCI(bm);
+        if(!e->root_moves.empty() && e->moveToUCI(e->root_moves[0].m)==r.bestmove){
+            const auto& rm = e->root_moves[0];
+            int sc = rm.score!=-INF_SCORE? rm.score : rm.prev_score;
+            if(sc>-INF_SCORE) toScore(sc, r.mate, r.score); // sem iteração completa: fica 0
+            for(const auto& m: rm.pv) r.pv.push_back(e->moveToUCI(m));
+        }else{
+            r.pv.push_back(r.bestmove); // lance de livro
+        }
+    }
+    e->on_info = nullptr;
+    { lock_guard<mutex> lk(halt->mx); halt->active = false; }
+    r.nodes = e->nodes;
+    r.time_ms = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now()-t0).count();
+    return r;
+}
+
+void Engine::stop(){
+    lock_guard<mutex> lk(halt->mx);
+    if(halt->active) halt->flag = true;
+}
+int  Engine::evaluate(){ return e->evaluate(); }
+
+void Engine::newGame(){
+    if(!e->keep_hash) e->clearTT();
+    e->clearHeuristics();
+    e->setStartPos();
+}
+
+bool Engine::setOption(const string& name, const string& value){
+    string n = name;
+    for(auto& c: n) c=(char)tolower((unsigned char)c);
+    return e->setOption(n, value);
+}
+
+const char* Engine::version(){
+    static const string v = ENGINE_NAME + " " + ENGINE_VERSION;
+    return v.c_str();
+}
+
+} // namespace deepbecky
+
+// ============ C ============
+struct db_engine { deepbecky::Engine eng; explicit db_engine(size_t mb) : eng(mb) {} };
+
+extern "C" {
+
+void db_limits_init(db_limits* lim){
+    *lim = db_limits();
+    lim->movetime_ms = -1;
+    lim->wtime_ms = lim->btime_ms = -1;
+    lim->multipv = 1;
+}
+
+db_engine* db_engine_new(size_t hash_mb){
+    try { return new db_engine(hash_mb? hash_mb : DEFAULT_HASH_MB); }
+    catch(...) { return nullptr; }
+}
+
+void db_engine_free(db_engine* e){ delete e; }
+
+int db_set_position(db_engine* e, const char* fen, const char* moves){
+    vector<string> mv;
+    if(moves){ stringstream ss(moves); string m; while(ss>>m) mv.push_back(m); }
+    return e->eng.setPosition(fen? fen : "startpos", mv) ? 1 : 0;
+}
+
+int db_search(db_engine* e, const db_limits* lim, db_info_cb cb, void* user,
+              char* bestmove, int* score, int* mate){
+    deepbecky::Limits l;
+    if(lim){
+        l.depth = lim->depth; l.movetime_ms = lim->movetime_ms; l.nodes = lim->nodes;
+        l.wtime_ms = lim->wtime_ms; l.btime_ms = lim->btime_ms;
+        l.winc_ms = lim->winc_ms;   l.binc_ms = lim->binc_ms;
+        l.infinite = lim->infinite!=0; l.multipv = lim->multipv; l.mate = lim->mate;
+        if(lim->searchmoves){ stringstream ss(lim->searchmoves); string m; while(ss>>m) l.searchmoves.push_back(m); }
+    }
+    deepbecky::InfoCallback f;
+    if(cb) f = [&](const deepbecky::Info& i){
+        string pv;
+        for(const auto& m: i.pv){ if(!pv.empty()) pv+=' '; pv+=m; }
+        db_info ci{ i.depth, i.multipv, i.mate? 1:0, i.score, i.nodes, i.time_ms, i.nps, pv.c_str() };
+        cb(&ci, user);
+    };
+    deepbecky::Result r = e->eng.search(l, f);
+    if(bestmove){ strncpy(bestmove, r.bestmove.c_str(), 5); bestmove[5]=0; }
+    if(score) *score = r.score;
+    if(mate) *mate = r.mate? 1:0;
+    return r.bestmove!="0000";
+}
+
+void db_stop(db_engine* e){ e->eng.stop(); }
+int  db_evaluate(db_engine* e){ return e->eng.evaluate(); }
+void db_new_game(db_engine* e){ e->eng.newGame(); }
+int  db_set_option(db_engine* e, const char* name, const char* value){
+    return e->eng.setOption(name? name : "", value? value : "") ? 1 : 0;
+}
+const char* db_version(void){ return deepbecky::Engine::version(); }
+
+} // extern "C"
@@ -0,0 +1,322 @@
+/*
+ * Deep Becky 0.2 - UCI Chess Engine
+ * Copyright (C) 2025-2026 Diogo de Oliveira Almeida
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ */
+
+// ============ Livro a partir de PGN (makebook) ============
+// deepbecky makebook --pgn games.pgn [--pgn more.pgn ...] --out book.bin
+//                    [--max-ply N] [--min-games N] [--threads T]
+//
+// Cada PGN é mapeado em memória e cortado em blocos nos "[Event"; T threads
+// puxam blocos e leem o SAN com o gerador legal da engine (só até max-ply).
+// Vitórias/empates/derrotas por (chave Polyglot, lance) vão para um mapa em
+// shards; no fim sai um livro Polyglot ordenado (peso = 2*V + E do ponto de
+// vista de quem joga), aberto com "setoption name BookFile".
+#include "engine.h"
+
+#include <unordered_map>
+
+namespace {
+
+struct BookOptions {
+    int maxPly = 30;
+    long long minGames = 3;
+    int threads = 1;
+};
+
+// ============ Agregação ============
+struct BookSlot {
+    uint64_t key;
+    uint16_t move;
+    bool operator==(const BookSlot& o) const { return key==o.key && move==o.move; }
+};
+struct BookSlotHash {
+    size_t operator()(const BookSlot& s) const { return (size_t)(s.key ^ (s.move * 0x9E3779B97F4A7C15ULL)); }
+};
+struct WDL { uint32_t w=0, d=0, l=0; };
+
+struct BookRecord { BookSlot slot; int8_t result; }; // result: 1/0/-1 para quem joga
+
+const int SHARDS = 64;
+
+class ShardedBook {
+public:
+    void add(const BookRecord* r, size_t n, int shard){
+        lock_guard<mutex> lk(mx[shard]);
+        auto& m = map[shard];
+        for(size_t i=0;i<n;i++){
+            WDL& v = m[r[i].slot];
+            if(r[i].result>0) v.w++; else if(r[i].result<0) v.l++; else v.d++;
+        }
+    }
+    static int shardOf(uint64_t key){ return (int)(key >> 58) & (SHARDS-1); }
+    const unordered_map<BookSlot, WDL, BookSlotHash>& shard(int i) const { return map[i]; }
+private:
+    mutex mx[SHARDS];
+    unordered_map<BookSlot, WDL, BookSlotHash> map[SHARDS];
+};
+
+// Registros locais da thread, despejados no shard em lotes (um lock por lote).
+struct LocalBuffer {
+    vector<BookRecord> buf[SHARDS];
+    ShardedBook& book;
+    explicit LocalBuffer(ShardedBook& b) : book(b) {}
+    ~LocalBuffer(){ flush(); }
+    void push(const BookRecord& r){
+        int s = ShardedBook::shardOf(r.slot.key);
+        buf[s].push_back(r);
+        if(buf[s].size()>=4096){ book.add(buf[s].data(), buf[s].size(), s); buf[s].clear(); }
+    }
+    void flush(){
+        for(int s=0;s<SHARDS;s++) if(!buf[s].empty()){ book.add(buf[s].data(), buf[s].size(), s); buf[s].clear(); }
+    }
+};
+
+// ============ SAN ============
+// Lance Polyglot: destino | origem<<6 | promoção<<12; roque = rei captura a torre.
+uint16_t polyglotMove(const Move& m){
+    int tx = m.to_x;
+    if(m.is_castle) tx = m.to_x==6? 7 : 0;
+    int promo = m.promotion? (m.promotion-1)%6 : 0;
+    return (uint16_t)(tx | m.to_y<<3 | m.from_x<<6 | m.from_y<<9 | promo<<12);
+}
+
+// Filtra os pseudo-legais pelo SAN e só testa a legalidade dos candidatos
+// (em geral um): bem mais barato que generateLegal a cada meio-lance.
+bool parseSAN(DeepBeckyEngine& e, string san, Move& out){
+    while(!san.empty() && strchr("+#!?", san.back())) san.pop_back();
+    if(san.empty()) return false;
+    vector<Move> pseudo = e.generatePseudo();
+    if(san=="O-O" || san=="0-0" || san=="O-O-O" || san=="0-0-0"){
+        int tx = san.size()==3? 6 : 2;
+        for(const auto& m: pseudo) if(m.is_castle && m.to_x==tx && e.legalMove(m)){ out = m; return true; }
+        return false;
+    }
+    int type = WPAWN; // tipo relativo às brancas
+    size_t i = 0;
+    if(const char* p = strchr("NBRQK", san[0])){ type = WKNIGHT + (int)(p - "NBRQK"); i = 1; }
+    int promo = 0;
+    size_t eq = san.find('=');
+    if(eq!=string::npos){
+        if(eq+1>=san.size()) return false;
+        const char* p = strchr("NBRQ", san[eq+1]);
+        if(!p) return false;
+        promo = WKNIGHT + (int)(p - "NBRQ");
+        san.resize(eq);
+    }else if(type==WPAWN && san.size()>=3 && strchr("NBRQ", san.back())){ // "e8Q"
+        promo = WKNIGHT + (int)(strchr("NBRQ", san.back()) - "NBRQ");
+        san.pop_back();
+    }
+    if(san.size()<i+2) return false;
+    int tx = san[san.size()-2]-'a', ty = san[san.size()-1]-'1';
+    if(!onBoard(tx,ty)) return false;
+    int fx=-1, fy=-1;
+    for(size_t k=i; k+2<san.size(); k++){
+        char c = san[k];
+        if(c>='a' && c<='h') fx = c-'a';
+        else if(c>='1' && c<='8') fy = c-'1';
+        else if(c!='x' && c!='-') return false;
+    }
+    int n = 0;
+    for(const auto& m: pseudo){
+        int p = e.b[m.from_y][m.from_x];
+        if(isBlackPiece(p)) p -= 6;
+        if(p!=type || m.to_x!=tx || m.to_y!=ty) continue;
+        if(fx>=0 && m.from_x!=fx) continue;
+        if(fy>=0 && m.from_y!=fy) continue;
+        int mp = m.promotion? (isBlackPiece(m.promotion)? m.promotion-6 : m.promotion) : 0;
+        if(mp!=promo || !e.legalMove(m)) continue;
+        out = m; n++;
+    }
+    return n==1;
+}
+
+// ============ PGN ============
+struct ParseStats { long long games=0, skipped=0, positions=0; };
+
+// Uma partida: tags já lidas, movetext em [p, end).
+void parseGame(DeepBeckyEngine& e, const char* p, const char* end, int result, const string& fen,
+               const BookOptions& o, LocalBuffer& out, ParseStats& st){
+    if(result==2){ st.skipped++; return; } // "*": sem resultado
+    if(fen.empty()) e.setStartPos(); else e.setFEN(fen);
+    int ply = 0, depth = 0;
+    string tok;
+    while(p<end && ply<o.maxPly){
+        char c = *p;
+        if(c=='{'){ while(p<end && *p!='}') p++; p++; continue; }
+        if(c==';'){ while(p<end && *p!='\n') p++; continue; }
+        if(c=='('){ depth++; p++; continue; }
+        if(c==')'){ depth = max(0, depth-1); p++; continue; }
+        if(isspace((unsigned char)c)){ p++; continue; }
+        const char* s = p;
+        while(p<end && !isspace((unsigned char)*p) && !strchr("{}();", *p)) p++;
+        if(depth) continue;
+        tok.assign(s, p);
+        if(tok[0]=='$') continue;
+        if(tok=="1-0" || tok=="0-1" || tok=="1/2-1/2" || tok=="*") break;
+        size_t k = 0; // número do lance: "12." ou "12...e5"
+        while(k<tok.size() && isdigit((unsigned char)tok[k])) k++;
+        if(k && k<tok.size() && tok[k]=='.'){ while(k<tok.size() && tok[k]=='.') k++; tok.erase(0, k); }
+        if(tok.empty()) continue;
+        Move m;
+        if(!parseSAN(e, tok, m)){ st.skipped++; return; }
+        int stm = e.white_to_move? result : -result;
+        out.push(BookRecord{ BookSlot{ e.polyglotKey(), polyglotMove(m) }, (int8_t)stm });
+        e.makeMove(m);
+        ply++;
+    }
+    st.games++;
+    st.positions += ply;
+}
+
+// Lê as partidas de [p, end); o bloco começa numa tag (ou no início do arquivo).
+void parseChunk(DeepBeckyEngine& e, const char* p, const char* end, const BookOptions& o,
+                LocalBuffer& out, ParseStats& st){
+    int result = 2;
+    string fen;
+    const char* moves = nullptr;
+    auto finish=[&](const char* stop){
+        if(moves) parseGame(e, moves, stop, result, fen, o, out, st);
+        moves = nullptr; result = 2; fen.clear();
+    };
+    while(p<end){
+        const char* eol = (const char*)memchr(p, '\n', (size_t)(end-p));
+        if(!eol) eol = end;
+        const char* q = p;
+        while(q<eol && (*q==' ' || *q=='\t' || *q=='\r')) q++;
+        if(q<eol && *q=='['){
+            if(moves) finish(p);
+            const char* v1 = (const char*)memchr(q, '"', (size_t)(eol-q));
+            const char* v2 = v1? (const char*)memchr(v1+1, '"', (size_t)(eol-v1-1)) : nullptr;
+            if(v1 && v2){
+                string name(q+1, v1), value(v1+1, v2);
+                while(!name.empty() && isspace((unsigned char)name.back())) name.pop_back();
+                if(name=="Result") result = value=="1-0"? 1 : value=="0-1"? -1 : value=="1/2-1/2"? 0 : 2;
+                else if(name=="FEN") fen = value;
+            }
+        }else if(q<eol && !moves){
+            moves = p;
+        }
+        p = eol<end? eol+1 : end;
+    }
+    finish(end);
+}
+
+// Corta [0, size) em blocos que começam em "[Event".
+vector<size_t> splitPGN(const char* data, size_t size, size_t parts){
+    vector<size_t> cuts(1, 0);
+    static const char TAG[] = "\n[Event ";
+    for(size_t i=1;i<parts;i++){
+        size_t at = max(cuts.back()+1, size*i/parts);
+        if(at>=size) break;
+        const char* f = search(data+at, data+size, TAG, TAG+sizeof(TAG)-1);
+        if(f==data+size) break;
+        size_t c = (size_t)(f-data)+1;
+        if(c>cuts.back()) cuts.push_back(c);
+    }
+    cuts.push_back(size);
+    return cuts;
+}
+
+// ============ Saída ============
+bool writeBook(const string& path, const ShardedBook& book, const BookOptions& o, size_t& written){
+    struct Out { uint64_t key; uint16_t move; uint32_t raw; };
+    vector<Out> all;
+    uint32_t maxRaw = 0;
+    for(int s=0;s<SHARDS;s++) for(const auto& kv: book.shard(s)){
+        const WDL& v = kv.second;
+        if((long long)v.w + v.d + v.l < o.minGames) continue;
+        uint32_t raw = 2*v.w + v.d;
+        if(!raw) continue; // só derrotas
+        all.push_back({ kv.first.key, kv.first.move, raw });
+        maxRaw = max(maxRaw, raw);
+    }
+    sort(all.begin(), all.end(), [](const Out& a, const Out& b){
+        if(a.key!=b.key) return a.key<b.key;
+        return a.raw!=b.raw? a.raw>b.raw : a.move<b.move;
+    });
+    ofstream f(path, ios::binary);
+    if(!f) return false;
+    vector<uint8_t> buf;
+    buf.reserve(16*65536);
+    auto be=[&](uint64_t v, int n){ for(int i=n-1;i>=0;i--) buf.push_back((uint8_t)(v>>(8*i))); };
+    for(const auto& e: all){
+        uint64_t w = maxRaw>65535? max<uint64_t>(1, (uint64_t)e.raw*65535/maxRaw) : e.raw;
+        be(e.key, 8); be(e.move, 2); be(w, 2); be(0, 4);
+        if(buf.size()>=16*65536){ f.write((const char*)buf.data(), (streamsize)buf.size()); buf.clear(); }
+    }
+    f.write((const char*)buf.data(), (streamsize)buf.size());
+    written = all.size();
+    return (bool)f;
+}
+
+} // namespace
+
+int runMakebook(int argc, char** argv){
+    BookOptions o;
+    vector<string> pgns;
+    string outPath;
+    o.threads = max(1u, thread::hardware_concurrency());
+    for(int i=2;i<argc;i++){
+        string a=argv[i];
+        auto next=[&](){ return (i+1<argc)? string(argv[++i]) : string(); };
+        if(a=="--pgn") pgns.push_back(next());
+        else if(a=="--out") outPath=next();
+        else if(a=="--max-ply") o.maxPly=max(1, atoi(next().c_str()));
+        else if(a=="--min-games") o.minGames=max(1LL, atoll(next().c_str()));
+        else if(a=="--threads") o.threads=atoi(next().c_str());
+    }
+    if(pgns.empty() || outPath.empty()){
+        cerr << "usage: deepbecky makebook --pgn games.pgn [--pgn more.pgn ...] --out book.bin"
+                " [--max-ply N] [--min-games N] [--threads T]" << endl;
+        return 1;
+    }
+    o.threads = max(1, min(o.threads, 256));
+
+    ShardedBook book;
+    ParseStats total;
+    size_t bytes = 0;
+    auto t0 = chrono::high_resolution_clock::now();
+    for(const auto& path: pgns){
+        MappedFile mf;
+        if(!mf.open(path)){ cerr << "cannot open " << path << endl; return 1; }
+        const char* data = (const char*)mf.data();
+        vector<size_t> cuts = splitPGN(data, mf.size(), (size_t)o.threads*16);
+        atomic<size_t> next{0};
+        mutex stMx;
+        auto worker=[&](){
+            DeepBeckyEngine e(1);
+            LocalBuffer out(book);
+            ParseStats st;
+            for(size_t c; (c = next++) + 1 < cuts.size(); )
+                parseChunk(e, data+cuts[c], data+cuts[c+1], o, out, st);
+            out.flush();
+            lock_guard<mutex> lk(stMx);
+            total.games += st.games; total.skipped += st.skipped; total.positions += st.positions;
+        };
+        vector<thread> pool;
+        for(int i=0;i<o.threads;i++) pool.emplace_back(worker);
+        for(auto& t: pool) t.join();
+        bytes += mf.size();
+    }
+    long long parseMs = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now()-t0).count();
+
+    size_t written = 0;
+    if(!writeBook(outPath, book, o, written)){ cerr << "cannot write " << outPath << endl; return 1; }
+    long long ms = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now()-t0).count();
+    cerr << "parsed " << total.games << " games (" << total.skipped << " skipped), " << total.positions
+         << " positions, " << fixed << setprecision(1) << bytes/1048576.0 << " MB in " << parseMs << " ms ("
+         << bytes/1048576.0*1000.0/max(1LL, parseMs) << " MB/s, " << o.threads << " threads)" << endl;
+    cerr << "wrote " << written << " entries to " << outPath << " in " << ms << " ms" << endl;
+    return 0;
+}
@@ -77,6 +77,15 @@ if errorlevel 1 (
   goto :END
 )
 
+REM ---- Biblioteca estatica (engine + API embutivel), sem o main
+echo [*] Biblioteca estatica...
+cl %CLFLAGS% /c engine.cpp api.cpp /Fo"%OUTDIR%\\"
+if errorlevel 1 (
+  echo [x] Erro na compilacao da biblioteca.
+  goto :END
+)
+lib /nologo /LTCG /OUT:"%OUTDIR%\deepbecky.lib" "%OUTDIR%\engine.obj" "%OUTDIR%\api.obj"
+
 REM ---- Compactacao opcional com UPX (mantenha 0 para torneio/benchmark)
 if "%USE_UPX%"=="1" (
   set "UPX_BIN="
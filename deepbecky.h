@@ -0,0 +1,123 @@
+/*
+ * Deep Becky 0.2 - UCI Chess Engine
+ * Copyright (C) 2025-2026 Diogo de Oliveira Almeida
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ */
+
+// API embutível do Deep Becky (C++). Cada Engine tem TT, heurísticas e
+// posição próprias: várias instâncias podem buscar ao mesmo tempo, uma por
+// thread. Uma mesma instância não deve ser usada por duas threads ao mesmo
+// tempo, exceto stop(), que pode ser chamado de qualquer thread.
+//
+//   deepbecky::Engine eng(64);
+//   eng.setPosition("startpos", {"e2e4", "e7e5"});
+//   deepbecky::Limits lim; lim.depth = 10;
+//   auto r = eng.search(lim, [](const deepbecky::Info& i){ ... });
+//   // r.bestmove == "g1f3", r.score em centipeões do lado a jogar
+#ifndef DEEPBECKY_H
+#define DEEPBECKY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifndef DEEPBECKY_API
+  #if defined(_WIN32) && defined(DEEPBECKY_DLL)
+    #ifdef DEEPBECKY_BUILD
+      #define DEEPBECKY_API __declspec(dllexport)
+    #else
+      #define DEEPBECKY_API __declspec(dllimport)
+    #endif
+  #else
+    #define DEEPBECKY_API
+  #endif
+#endif
+
+class DeepBeckyEngine;
+
+namespace deepbecky {
+
+// Limites da busca; campos zerados/negativos = sem limite. Sem nenhum limite
+// a busca só termina com stop().
+struct Limits {
+    int depth = 0;
+    int movetime_ms = -1;
+    long long nodes = 0;
+    int wtime_ms = -1, btime_ms = -1, winc_ms = 0, binc_ms = 0;
+    bool infinite = false;
+    int multipv = 1;
+    int mate = 0;                         // > 0: só procura mate em até N lances
+    std::vector<std::string> searchmoves; // lances UCI permitidos na raiz
+};
+
+// Uma linha por iteração (e por multipv), na ordem em que a busca produz.
+struct Info {
+    int depth = 0;
+    int multipv = 1;
+    bool mate = false;  // score = lances até o mate (negativo = levando mate)
+    int score = 0;      // centipeões do lado a jogar
+    long long nodes = 0;
+    long long time_ms = 0;
+    long long nps = 0;
+    std::vector<std::string> pv;
+};
+
+struct Result {
+    std::string bestmove; // "0000" sem lances legais
+    bool mate = false;
+    int score = 0;
+    std::vector<std::string> pv;
+    int depth = 0;
+    long long nodes = 0;
+    long long time_ms = 0;
+};
+
+using InfoCallback = std::function<void(const Info&)>;
+
+class DEEPBECKY_API Engine {
+public:
+    explicit Engine(std::size_t hashMB = 192);
+    ~Engine();
+    Engine(const Engine&) = delete;
+    Engine& operator=(const Engine&) = delete;
+
+    // fen "startpos" (ou vazio) = posição inicial; lances em notação UCI.
+    // Retorna false em FEN/lance inválido (a posição fica até o último lance válido).
+    bool setPosition(const std::string& fen, const std::vector<std::string>& moves = {});
+
+    Result search(const Limits& limits, const InfoCallback& onInfo = nullptr);
+    // Corta a busca em andamento (nunca se perde, mesmo logo no início dela);
+    // sem busca em andamento não faz nada.
+    void stop();
+
+    // Avaliação estática (centipeões, lado a jogar)
+    int evaluate();
+
+    // Esquece TT (salvo com NeverClearHash) e heurísticas (nova partida)
+    void newGame();
+    // Mesmas opções do UCI: Hash, MultiPV, OwnBook, BookFile, NeverClearHash
+    bool setOption(const std::string& name, const std::string& value);
+
+    static const char* version();
+
+private:
+    struct Halt;
+    std::unique_ptr<DeepBeckyEngine> e;
+    std::unique_ptr<Halt> halt;
+};
+
+} // namespace deepbecky
+
+#endif // DEEPBECKY_H
@@ -0,0 +1,81 @@
+/*
+ * Deep Becky 0.2 - UCI Chess Engine
+ * Copyright (C) 2025-2026 Diogo de Oliveira Almeida
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ */
+
+// API embutível do Deep Becky (C). Casca fina sobre deepbecky.h para quem
+// liga de C, Python (ctypes), etc. Mesmas regras de threads: um db_engine
+// por thread; db_stop pode ser chamado de qualquer thread.
+#ifndef DEEPBECKY_C_H
+#define DEEPBECKY_C_H
+
+#include <stddef.h>
+
+#ifndef DEEPBECKY_API
+  #if defined(_WIN32) && defined(DEEPBECKY_DLL)
+    #ifdef DEEPBECKY_BUILD
+      #define DEEPBECKY_API __declspec(dllexport)
+    #else
+      #define DEEPBECKY_API __declspec(dllimport)
+    #endif
+  #else
+    #define DEEPBECKY_API
+  #endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct db_engine db_engine;
+
+typedef struct db_limits {
+    int depth;          /* 0 = sem limite */
+    int movetime_ms;    /* -1 = sem limite */
+    long long nodes;    /* 0 = sem limite */
+    int wtime_ms, btime_ms, winc_ms, binc_ms; /* -1/0 = não usado */
+    int infinite;
+    int multipv;
+    int mate;           /* > 0: só procura mate em até N lances */
+    const char* searchmoves; /* lances UCI permitidos na raiz, separados por espaço (NULL = todos) */
+} db_limits;
+
+typedef struct db_info {
+    int depth, multipv;
+    int mate;           /* 1: score = lances até o mate */
+    int score;
+    long long nodes, time_ms, nps;
+    const char* pv;     /* lances UCI separados por espaço; válido só durante o callback */
+} db_info;
+
+typedef void (*db_info_cb)(const db_info* info, void* user);
+
+DEEPBECKY_API void        db_limits_init(db_limits* lim);
+DEEPBECKY_API db_engine*  db_engine_new(size_t hash_mb);
+DEEPBECKY_API void        db_engine_free(db_engine* e);
+/* fen: "startpos" ou FEN; moves: lances UCI separados por espaço (pode ser NULL). 0 = inválido */
+DEEPBECKY_API int         db_set_position(db_engine* e, const char* fen, const char* moves);
+/* Escreve o melhor lance em bestmove (>= 6 bytes); score/mate podem ser NULL. */
+DEEPBECKY_API int         db_search(db_engine* e, const db_limits* lim, db_info_cb cb, void* user,
+                                    char* bestmove, int* score, int* mate);
+DEEPBECKY_API void        db_stop(db_engine* e);
+DEEPBECKY_API int         db_evaluate(db_engine* e);
+DEEPBECKY_API void        db_new_game(db_engine* e);
+DEEPBECKY_API int         db_set_option(db_engine* e, const char* name, const char* value);
+DEEPBECKY_API const char* db_version(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DEEPBECKY_C_H */
@@ -0,0 +1,2352 @@
+/*
+ * Deep Becky 0.2 - UCI Chess Engine
+ * Copyright (C) 2025-2026 Diogo de Oliveira Almeida
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ */
+
+#include "engine.h"
+
+#ifdef _WIN32
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #include <windows.h>
+#else
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
+
+Zobrist ZOB;
+LmrTable LMR;
+KPKBitbase KPK;
+
+// ========================= Poda =========================
+static const int RFP_MAX_DEPTH = 4;   // reverse futility só perto das folhas
+static const int RFP_MARGIN    = 90;  // por ply
+static const int FP_MAX_DEPTH  = 3;
+static const int FP_MARGIN[FP_MAX_DEPTH+1] = { 0, 150, 300, 500 };
+static const int LMP_MAX_DEPTH = 3;
+static const int NMP_MIN_DEPTH = 3;
+static const int LMR_MIN_DEPTH = 3;
+static const int LMR_HIST_DIV  = 8192; // cada LMR_HIST_DIV de history = 1 ply a menos/mais
+
+// ========================= Avaliação =========================
+// Só para ordenação (MVV-LVA); os pesos da avaliação ficam em EvalParams.
+static const int PIECE_VALUE[13] = {
+    0, 100, 320, 330, 500, 900, 20000, 100, 320, 330, 500, 900, 20000
+};
+
+#include "eval_params.h"
+
+// Parâmetros padrão: o vetor único montado a partir de eval_params.h
+static EvalParams defaultEvalParams(){
+    EvalParams e;
+    for(int t=0;t<5;t++) e.v[EP_MATERIAL+t] = EVAL_MATERIAL[t];
+    for(int t=0;t<PST_NB;t++) for(int i=0;i<64;i++) e.v[EP_PST+t*64+i] = EVAL_PST[t][i];
+    e.v[EP_BISHOP_PAIR] = EVAL_BISHOP_PAIR;
+    e.v[EP_MOBILITY]    = EVAL_MOBILITY;
+    return e;
+}
+const EvalParams EVAL_DEFAULT = defaultEvalParams();
+
+// Os inteiros depois do #define, na ordem do cabeçalho, são exatamente v[];
+// comentários e dimensões entre colchetes são ignorados.
+bool loadEvalParams(const string& path, EvalParams& out){
+    ifstream in(path);
+    if(!in) return false;
+    string line;
+    bool body = false;
+    int n = 0;
+    EvalParams p;
+    while(getline(in, line)){
+        if(!body){ body = line.rfind("#define", 0)==0; continue; }
+        size_t c = line.find("//");
+        if(c!=string::npos) line.resize(c);
+        for(size_t i=0;i<line.size();i++){
+            if(line[i]=='['){ size_t e=line.find(']', i); if(e==string::npos) break; i=e; continue; }
+            bool neg = line[i]=='-' && i+1<line.size() && isdigit((unsigned char)line[i+1]);
+            if(!neg && !isdigit((unsigned char)line[i])) continue;
+            if(isalnum((unsigned char)(i? line[i-1] : ' ')) || (i && line[i-1]=='_')) continue;
+            size_t e;
+            long v = stol(line.substr(i), &e);
+            if(n>=EP_NB) return false;
+            p.v[n++] = (int)v;
+            i += e-1;
+        }
+    }
+    if(n!=EP_NB) return false;
+    out = p;
+    return true;
+}
+
+// ========================= Livro Polyglot =========================
+// Chaves Zobrist padrão do formato Polyglot: 12x64 peças, 4 roques, 8 colunas
+// de en passant e vez das brancas.
+static const uint64_t POLYGLOT_RANDOM[781] = {
+    0x9D39247E33776D41, 0x2AF7398005AAA5C7, 0x44DB015024623547, 0x9C15F73E62A76AE2,
+    0x75834465489C0C89, 0x3290AC3A203001BF, 0x0FBBAD1F61042279, 0xE83A908FF2FB60CA,
+    0x0D7E765D58755C10, 0x1A083822CEAFE02D, 0x9605D5F0E25EC3B0, 0xD021FF5CD13A2ED5,
+    0x40BDF15D4A672E32, 0x011355146FD56395, 0x5DB4832046F3D9E5, 0x239F8B2D7FF719CC,
+    0x05D1A1AE85B49AA1, 0x679F848F6E8FC971, 0x7449BBFF801FED0B, 0x7D11CDB1C3B7ADF0,
+    0x82C7709E781EB7CC, 0xF3218F1C9510786C, 0x331478F3AF51BBE6, 0x4BB38DE5E7219443,
+    0xAA649C6EBCFD50FC, 0x8DBD98A352AFD40B, 0x87D2074B81D79217, 0x19F3C751D3E92AE1,
+    0xB4AB30F062B19ABF, 0x7B0500AC42047AC4, 0xC9452CA81A09D85D, 0x24AA6C514DA27500,
+    0x4C9F34427501B447, 0x14A68FD73C910841, 0xA71B9B83461CBD93, 0x03488B95B0F1850F,
+    0x637B2B34FF93C040, 0x09D1BC9A3DD90A94, 0x3575668334A1DD3B, 0x735E2B97A4C45A23,
+    0x18727070F1BD400B, 0x1FCBACD259BF02E7, 0xD310A7C2CE9B6555, 0xBF983FE0FE5D8244,
+    0x9F74D14F7454A824, 0x51EBDC4AB9BA3035, 0x5C82C505DB9AB0FA, 0xFCF7FE8A3430B241,
+    0x3253A729B9BA3DDE, 0x8C74C368081B3075, 0xB9BC6C87167C33E7, 0x7EF48F2B83024E20,
+    0x11D505D4C351BD7F, 0x6568FCA92C76A243, 0x4DE0B0F40F32A7B8, 0x96D693460CC37E5D,
+    0x42E240CB63689F2F, 0x6D2BDCDAE2919661, 0x42880B0236E4D951, 0x5F0F4A5898171BB6,
+    0x39F890F579F92F88, 0x93C5B5F47356388B, 0x63DC359D8D231B78, 0xEC16CA8AEA98AD76,
+    0x5355F900C2A82DC7, 0x07FB9F855A997142, 0x5093417AA8A7ED5E, 0x7BCBC38DA25A7F3C,
+    0x19FC8A768CF4B6D4, 0x637A7780DECFC0D9, 0x8249A47AEE0E41F7, 0x79AD695501E7D1E8,
+    0x14ACBAF4777D5776, 0xF145B6BECCDEA195, 0xDABF2AC8201752FC, 0x24C3C94DF9C8D3F6,
+    0xBB6E2924F03912EA, 0x0CE26C0B95C980D9, 0xA49CD132BFBF7CC4, 0xE99D662AF4243939,
+    0x27E6AD7891165C3F, 0x8535F040B9744FF1, 0x54B3F4FA5F40D873, 0x72B12C32127FED2B,
+    0xEE954D3C7B411F47, 0x9A85AC909A24EAA1, 0x70AC4CD9F04F21F5, 0xF9B89D3E99A075C2,
+    0x87B3E2B2B5C907B1, 0xA366E5B8C54F48B8, 0xAE4A9346CC3F7CF2, 0x1920C04D47267BBD,
+    0x87BF02C6B49E2AE9, 0x092237AC237F3859, 0xFF07F64EF8ED14D0, 0x8DE8DCA9F03CC54E,
+    0x9C1633264DB49C89, 0xB3F22C3D0B0B38ED, 0x390E5FB44D01144B, 0x5BFEA5B4712768E9,
+    0x1E1032911FA78984, 0x9A74ACB964E78CB3, 0x4F80F7A035DAFB04, 0x6304D09A0B3738C4,
+    0x2171E64683023A08, 0x5B9B63EB9CEFF80C, 0x506AACF489889342, 0x1881AFC9A3A701D6,
+    0x6503080440750644, 0xDFD395339CDBF4A7, 0xEF927DBCF00C20F2, 0x7B32F7D1E03680EC,
+    0xB9FD7620E7316243, 0x05A7E8A57DB91B77, 0xB5889C6E15630A75, 0x4A750A09CE9573F7,
+    0xCF464CEC899A2F8A, 0xF538639CE705B824, 0x3C79A0FF5580EF7F, 0xEDE6C87F8477609D,
+    0x799E81F05BC93F31, 0x86536B8CF3428A8C, 0x97D7374C60087B73, 0xA246637CFF328532,
+    0x043FCAE60CC0EBA0, 0x920E449535DD359E, 0x70EB093B15B290CC, 0x73A1921916591CBD,
+    0x56436C9FE1A1AA8D, 0xEFAC4B70633B8F81, 0xBB215798D45DF7AF, 0x45F20042F24F1768,
+    0x930F80F4E8EB7462, 0xFF6712FFCFD75EA1, 0xAE623FD67468AA70, 0xDD2C5BC84BC8D8FC,
+    0x7EED120D54CF2DD9, 0x22FE545401165F1C, 0xC91800E98FB99929, 0x808BD68E6AC10365,
+    0xDEC468145B7605F6, 0x1BEDE3A3AEF53302, 0x43539603D6C55602, 0xAA969B5C691CCB7A,
+    0xA87832D392EFEE56, 0x65942C7B3C7E11AE, 0xDED2D633CAD004F6, 0x21F08570F420E565,
+    0xB415938D7DA94E3C, 0x91B859E59ECB6350, 0x10CFF333E0ED804A, 0x28AED140BE0BB7DD,
+    0xC5CC1D89724FA456, 0x5648F680F11A2741, 0x2D255069F0B7DAB3, 0x9BC5A38EF729ABD4,
+    0xEF2F054308F6A2BC, 0xAF2042F5CC5C2858, 0x480412BAB7F5BE2A, 0xAEF3AF4A563DFE43,
+    0x19AFE59AE451497F, 0x52593803DFF1E840, 0xF4F076E65F2CE6F0, 0x11379625747D5AF3,
+    0xBCE5D2248682C115, 0x9DA4243DE836994F, 0x066F70B33FE09017, 0x4DC4DE189B671A1C,
+    0x51039AB7712457C3, 0xC07A3F80C31FB4B4, 0xB46EE9C5E64A6E7C, 0xB3819A42ABE61C87,
+    0x21A007933A522A20, 0x2DF16F761598AA4F, 0x763C4A1371B368FD, 0xF793C46702E086A0,
+    0xD7288E012AEB8D31, 0xDE336A2A4BC1C44B, 0x0BF692B38D079F23, 0x2C604A7A177326B3,
+    0x4850E73E03EB6064, 0xCFC447F1E53C8E1B, 0xB05CA3F564268D99, 0x9AE182C8BC9474E8,
+    0xA4FC4BD4FC5558CA, 0xE755178D58FC4E76, 0x69B97DB1A4C03DFE, 0xF9B5B7C4ACC67C96,
+    0xFC6A82D64B8655FB, 0x9C684CB6C4D24417, 0x8EC97D2917456ED0, 0x6703DF9D2924E97E,
+    0xC547F57E42A7444E, 0x78E37644E7CAD29E, 0xFE9A44E9362F05FA, 0x08BD35CC38336615,
+    0x9315E5EB3A129ACE, 0x94061B871E04DF75, 0xDF1D9F9D784BA010, 0x3BBA57B68871B59D,
+    0xD2B7ADEEDED1F73F, 0xF7A255D83BC373F8, 0xD7F4F2448C0CEB81, 0xD95BE88CD210FFA7,
+    0x336F52F8FF4728E7, 0xA74049DAC312AC71, 0xA2F61BB6E437FDB5, 0x4F2A5CB07F6A35B3,
+    0x87D380BDA5BF7859, 0x16B9F7E06C453A21, 0x7BA2484C8A0FD54E, 0xF3A678CAD9A2E38C,
+    0x39B0BF7DDE437BA2, 0xFCAF55C1BF8A4424, 0x18FCF680573FA594, 0x4C0563B89F495AC3,
+    0x40E087931A00930D, 0x8CFFA9412EB642C1, 0x68CA39053261169F, 0x7A1EE967D27579E2,
+    0x9D1D60E5076F5B6F, 0x3810E399B6F65BA2, 0x32095B6D4AB5F9B1, 0x35CAB62109DD038A,
+    0xA90B24499FCFAFB1, 0x77A225A07CC2C6BD, 0x513E5E634C70E331, 0x4361C0CA3F692F12,
+    0xD941ACA44B20A45B, 0x528F7C8602C5807B, 0x52AB92BEB9613989, 0x9D1DFA2EFC557F73,
+    0x722FF175F572C348, 0x1D1260A51107FE97, 0x7A249A57EC0C9BA2, 0x04208FE9E8F7F2D6,
+    0x5A110C6058B920A0, 0x0CD9A497658A5698, 0x56FD23C8F9715A4C, 0x284C847B9D887AAE,
+    0x04FEABFBBDB619CB, 0x742E1E651C60BA83, 0x9A9632E65904AD3C, 0x881B82A13B51B9E2,
+    0x506E6744CD974924, 0xB0183DB56FFC6A79, 0x0ED9B915C66ED37E, 0x5E11E86D5873D484,
+    0xF678647E3519AC6E, 0x1B85D488D0F20CC5, 0xDAB9FE6525D89021, 0x0D151D86ADB73615,
+    0xA865A54EDCC0F019, 0x93C42566AEF98FFB, 0x99E7AFEABE000731, 0x48CBFF086DDF285A,
+    0x7F9B6AF1EBF78BAF, 0x58627E1A149BBA21, 0x2CD16E2ABD791E33, 0xD363EFF5F0977996,
+    0x0CE2A38C344A6EED, 0x1A804AADB9CFA741, 0x907F30421D78C5DE, 0x501F65EDB3034D07,
+    0x37624AE5A48FA6E9, 0x957BAF61700CFF4E, 0x3A6C27934E31188A, 0xD49503536ABCA345,
+    0x088E049589C432E0, 0xF943AEE7FEBF21B8, 0x6C3B8E3E336139D3, 0x364F6FFA464EE52E,
+    0xD60F6DCEDC314222, 0x56963B0DCA418FC0, 0x16F50EDF91E513AF, 0xEF1955914B609F93,
+    0x565601C0364E3228, 0xECB53939887E8175, 0xBAC7A9A18531294B, 0xB344C470397BBA52,
+    0x65D34954DAF3CEBD, 0xB4B81B3FA97511E2, 0xB422061193D6F6A7, 0x071582401C38434D,
+    0x7A13F18BBEDC4FF5, 0xBC4097B116C524D2, 0x59B97885E2F2EA28, 0x99170A5DC3115544,
+    0x6F423357E7C6A9F9, 0x325928EE6E6F8794, 0xD0E4366228B03343, 0x565C31F7DE89EA27,
+    0x30F5611484119414, 0xD873DB391292ED4F, 0x7BD94E1D8E17DEBC, 0xC7D9F16864A76E94,
+    0x947AE053EE56E63C, 0xC8C93882F9475F5F, 0x3A9BF55BA91F81CA, 0xD9A11FBB3D9808E4,
+    0x0FD22063EDC29FCA, 0xB3F256D8ACA0B0B9, 0xB03031A8B4516E84, 0x35DD37D5871448AF,
+    0xE9F6082B05542E4E, 0xEBFAFA33D7254B59, 0x9255ABB50D532280, 0xB9AB4CE57F2D34F3,
+    0x693501D628297551, 0xC62C58F97DD949BF, 0xCD454F8F19C5126A, 0xBBE83F4ECC2BDECB,
+    0xDC842B7E2819E230, 0xBA89142E007503B8, 0xA3BC941D0A5061CB, 0xE9F6760E32CD8021,
+    0x09C7E552BC76492F, 0x852F54934DA55CC9, 0x8107FCCF064FCF56, 0x098954D51FFF6580,
+    0x23B70EDB1955C4BF, 0xC330DE426430F69D, 0x4715ED43E8A45C0A, 0xA8D7E4DAB780A08D,
+    0x0572B974F03CE0BB, 0xB57D2E985E1419C7, 0xE8D9ECBE2CF3D73F, 0x2FE4B17170E59750,
+    0x11317BA87905E790, 0x7FBF21EC8A1F45EC, 0x1725CABFCB045B00, 0x964E915CD5E2B207,
+    0x3E2B8BCBF016D66D, 0xBE7444E39328A0AC, 0xF85B2B4FBCDE44B7, 0x49353FEA39BA63B1,
+    0x1DD01AAFCD53486A, 0x1FCA8A92FD719F85, 0xFC7C95D827357AFA, 0x18A6A990C8B35EBD,
+    0xCCCB7005C6B9C28D, 0x3BDBB92C43B17F26, 0xAA70B5B4F89695A2, 0xE94C39A54A98307F,
+    0xB7A0B174CFF6F36E, 0xD4DBA84729AF48AD, 0x2E18BC1AD9704A68, 0x2DE0966DAF2F8B1C,
+    0xB9C11D5B1E43A07E, 0x64972D68DEE33360, 0x94628D38D0C20584, 0xDBC0D2B6AB90A559,
+    0xD2733C4335C6A72F, 0x7E75D99D94A70F4D, 0x6CED1983376FA72B, 0x97FCAACBF030BC24,
+    0x7B77497B32503B12, 0x8547EDDFB81CCB94, 0x79999CDFF70902CB, 0xCFFE1939438E9B24,
+    0x829626E3892D95D7, 0x92FAE24291F2B3F1, 0x63E22C147B9C3403, 0xC678B6D860284A1C,
+    0x5873888850659AE7, 0x0981DCD296A8736D, 0x9F65789A6509A440, 0x9FF38FED72E9052F,
+    0xE479EE5B9930578C, 0xE7F28ECD2D49EECD, 0x56C074A581EA17FE, 0x5544F7D774B14AEF,
+    0x7B3F0195FC6F290F, 0x12153635B2C0CF57, 0x7F5126DBBA5E0CA7, 0x7A76956C3EAFB413,
+    0x3D5774A11D31AB39, 0x8A1B083821F40CB4, 0x7B4A38E32537DF62, 0x950113646D1D6E03,
+    0x4DA8979A0041E8A9, 0x3BC36E078F7515D7, 0x5D0A12F27AD310D1, 0x7F9D1A2E1EBE1327,
+    0xDA3A361B1C5157B1, 0xDCDD7D20903D0C25, 0x36833336D068F707, 0xCE68341F79893389,
+    0xAB9090168DD05F34, 0x43954B3252DC25E5, 0xB438C2B67F98E5E9, 0x10DCD78E3851A492,
+    0xDBC27AB5447822BF, 0x9B3CDB65F82CA382, 0xB67B7896167B4C84, 0xBFCED1B0048EAC50,
+    0xA9119B60369FFEBD, 0x1FFF7AC80904BF45, 0xAC12FB171817EEE7, 0xAF08DA9177DDA93D,
+    0x1B0CAB936E65C744, 0xB559EB1D04E5E932, 0xC37B45B3F8D6F2BA, 0xC3A9DC228CAAC9E9,
+    0xF3B8B6675A6507FF, 0x9FC477DE4ED681DA, 0x67378D8ECCEF96CB, 0x6DD856D94D259236,
+    0xA319CE15B0B4DB31, 0x073973751F12DD5E, 0x8A8E849EB32781A5, 0xE1925C71285279F5,
+    0x74C04BF1790C0EFE, 0x4DDA48153C94938A, 0x9D266D6A1CC0542C, 0x7440FB816508C4FE,
+    0x13328503DF48229F, 0xD6BF7BAEE43CAC40, 0x4838D65F6EF6748F, 0x1E152328F3318DEA,
+    0x8F8419A348F296BF, 0x72C8834A5957B511, 0xD7A023A73260B45C, 0x94EBC8ABCFB56DAE,
+    0x9FC10D0F989993E0, 0xDE68A2355B93CAE6, 0xA44CFE79AE538BBE, 0x9D1D84FCCE371425,
+    0x51D2B1AB2DDFB636, 0x2FD7E4B9E72CD38C, 0x65CA5B96B7552210, 0xDD69A0D8AB3B546D,
+    0x604D51B25FBF70E2, 0x73AA8A564FB7AC9E, 0x1A8C1E992B941148, 0xAAC40A2703D9BEA0,
+    0x764DBEAE7FA4F3A6, 0x1E99B96E70A9BE8B, 0x2C5E9DEB57EF4743, 0x3A938FEE32D29981,
+    0x26E6DB8FFDF5ADFE, 0x469356C504EC9F9D, 0xC8763C5B08D1908C, 0x3F6C6AF859D80055,
+    0x7F7CC39420A3A545, 0x9BFB227EBDF4C5CE, 0x89039D79D6FC5C5C, 0x8FE88B57305E2AB6,
+    0xA09E8C8C35AB96DE, 0xFA7E393983325753, 0xD6B6D0ECC617C699, 0xDFEA21EA9E7557E3,
+    0xB67C1FA481680AF8, 0xCA1E3785A9E724E5, 0x1CFC8BED0D681639, 0xD18D8549D140CAEA,
+    0x4ED0FE7E9DC91335, 0xE4DBF0634473F5D2, 0x1761F93A44D5AEFE, 0x53898E4C3910DA55,
+    0x734DE8181F6EC39A, 0x2680B122BAA28D97, 0x298AF231C85BAFAB, 0x7983EED3740847D5,
+    0x66C1A2A1A60CD889, 0x9E17E49642A3E4C1, 0xEDB454E7BADC0805, 0x50B704CAB602C329,
+    0x4CC317FB9CDDD023, 0x66B4835D9EAFEA22, 0x219B97E26FFC81BD, 0x261E4E4C0A333A9D,
+    0x1FE2CCA76517DB90, 0xD7504DFA8816EDBB, 0xB9571FA04DC089C8, 0x1DDC0325259B27DE,
+    0xCF3F4688801EB9AA, 0xF4F5D05C10CAB243, 0x38B6525C21A42B0E, 0x36F60E2BA4FA6800,
+    0xEB3593803173E0CE, 0x9C4CD6257C5A3603, 0xAF0C317D32ADAA8A, 0x258E5A80C7204C4B,
+    0x8B889D624D44885D, 0xF4D14597E660F855, 0xD4347F66EC8941C3, 0xE699ED85B0DFB40D,
+    0x2472F6207C2D0484, 0xC2A1E7B5B459AEB5, 0xAB4F6451CC1D45EC, 0x63767572AE3D6174,
+    0xA59E0BD101731A28, 0x116D0016CB948F09, 0x2CF9C8CA052F6E9F, 0x0B090A7560A968E3,
+    0xABEEDDB2DDE06FF1, 0x58EFC10B06A2068D, 0xC6E57A78FBD986E0, 0x2EAB8CA63CE802D7,
+    0x14A195640116F336, 0x7C0828DD624EC390, 0xD74BBE77E6116AC7, 0x804456AF10F5FB53,
+    0xEBE9EA2ADF4321C7, 0x03219A39EE587A30, 0x49787FEF17AF9924, 0xA1E9300CD8520548,
+    0x5B45E522E4B1B4EF, 0xB49C3B3995091A36, 0xD4490AD526F14431, 0x12A8F216AF9418C2,
+    0x001F837CC7350524, 0x1877B51E57A764D5, 0xA2853B80F17F58EE, 0x993E1DE72D36D310,
+    0xB3598080CE64A656, 0x252F59CF0D9F04BB, 0xD23C8E176D113600, 0x1BDA0492E7E4586E,
+    0x21E0BD5026C619BF, 0x3B097ADAF088F94E, 0x8D14DEDB30BE846E, 0xF95CFFA23AF5F6F4,
+    0x3871700761B3F743, 0xCA672B91E9E4FA16, 0x64C8E531BFF53B55, 0x241260ED4AD1E87D,
+    0x106C09B972D2E822, 0x7FBA195410E5CA30, 0x7884D9BC6CB569D8, 0x0647DFEDCD894A29,
+    0x63573FF03E224774, 0x4FC8E9560F91B123, 0x1DB956E450275779, 0xB8D91274B9E9D4FB,
+    0xA2EBEE47E2FBFCE1, 0xD9F1F30CCD97FB09, 0xEFED53D75FD64E6B, 0x2E6D02C36017F67F,
+    0xA9AA4D20DB084E9B, 0xB64BE8D8B25396C1, 0x70CB6AF7C2D5BCF0, 0x98F076A4F7A2322E,
+    0xBF84470805E69B5F, 0x94C3251F06F90CF3, 0x3E003E616A6591E9, 0xB925A6CD0421AFF3,
+    0x61BDD1307C66E300, 0xBF8D5108E27E0D48, 0x240AB57A8B888B20, 0xFC87614BAF287E07,
+    0xEF02CDD06FFDB432, 0xA1082C0466DF6C0A, 0x8215E577001332C8, 0xD39BB9C3A48DB6CF,
+    0x2738259634305C14, 0x61CF4F94C97DF93D, 0x1B6BACA2AE4E125B, 0x758F450C88572E0B,
+    0x959F587D507A8359, 0xB063E962E045F54D, 0x60E8ED72C0DFF5D1, 0x7B64978555326F9F,
+    0xFD080D236DA814BA, 0x8C90FD9B083F4558, 0x106F72FE81E2C590, 0x7976033A39F7D952,
+    0xA4EC0132764CA04B, 0x733EA705FAE4FA77, 0xB4D8F77BC3E56167, 0x9E21F4F903B33FD9,
+    0x9D765E419FB69F6D, 0xD30C088BA61EA5EF, 0x5D94337FBFAF7F5B, 0x1A4E4822EB4D7A59,
+    0x6FFE73E81B637FB3, 0xDDF957BC36D8B9CA, 0x64D0E29EEA8838B3, 0x08DD9BDFD96B9F63,
+    0x087E79E5A57D1D13, 0xE328E230E3E2B3FB, 0x1C2559E30F0946BE, 0x720BF5F26F4D2EAA,
+    0xB0774D261CC609DB, 0x443F64EC5A371195, 0x4112CF68649A260E, 0xD813F2FAB7F5C5CA,
+    0x660D3257380841EE, 0x59AC2C7873F910A3, 0xE846963877671A17, 0x93B633ABFA3469F8,
+    0xC0C0F5A60EF4CDCF, 0xCAF21ECD4377B28C, 0x57277707199B8175, 0x506C11B9D90E8B1D,
+    0xD83CC2687A19255F, 0x4A29C6465A314CD1, 0xED2DF21216235097, 0xB5635C95FF7296E2,
+    0x22AF003AB672E811, 0x52E762596BF68235, 0x9AEBA33AC6ECC6B0, 0x944F6DE09134DFB6,
+    0x6C47BEC883A7DE39, 0x6AD047C430A12104, 0xA5B1CFDBA0AB4067, 0x7C45D833AFF07862,
+    0x5092EF950A16DA0B, 0x9338E69C052B8E7B, 0x455A4B4CFE30E3F5, 0x6B02E63195AD0CF8,
+    0x6B17B224BAD6BF27, 0xD1E0CCD25BB9C169, 0xDE0C89A556B9AE70, 0x50065E535A213CF6,
+    0x9C1169FA2777B874, 0x78EDEFD694AF1EED, 0x6DC93D9526A50E68, 0xEE97F453F06791ED,
+    0x32AB0EDB696703D3, 0x3A6853C7E70757A7, 0x31865CED6120F37D, 0x67FEF95D92607890,
+    0x1F2B1D1F15F6DC9C, 0xB69E38A8965C6B65, 0xAA9119FF184CCCF4, 0xF43C732873F24C13,
+    0xFB4A3D794A9A80D2, 0x3550C2321FD6109C, 0x371F77E76BB8417E, 0x6BFA9AAE5EC05779,
+    0xCD04F3FF001A4778, 0xE3273522064480CA, 0x9F91508BFFCFC14A, 0x049A7F41061A9E60,
+    0xFCB6BE43A9F2FE9B, 0x08DE8A1C7797DA9B, 0x8F9887E6078735A1, 0xB5B4071DBFC73A66,
+    0x230E343DFBA08D33, 0x43ED7F5A0FAE657D, 0x3A88A0FBBCB05C63, 0x21874B8B4D2DBC4F,
+    0x1BDEA12E35F6A8C9, 0x53C065C6C8E63528, 0xE34A1D250E7A8D6B, 0xD6B04D3B7651DD7E,
+    0x5E90277E7CB39E2D, 0x2C046F22062DC67D, 0xB10BB459132D0A26, 0x3FA9DDFB67E2F199,
+    0x0E09B88E1914F7AF, 0x10E8B35AF3EEAB37, 0x9EEDECA8E272B933, 0xD4C718BC4AE8AE5F,
+    0x81536D601170FC20, 0x91B534F885818A06, 0xEC8177F83F900978, 0x190E714FADA5156E,
+    0xB592BF39B0364963, 0x89C350C893AE7DC1, 0xAC042E70F8B383F2, 0xB49B52E587A1EE60,
+    0xFB152FE3FF26DA89, 0x3E666E6F69AE2C15, 0x3B544EBE544C19F9, 0xE805A1E290CF2456,
+    0x24B33C9D7ED25117, 0xE74733427B72F0C1, 0x0A804D18B7097475, 0x57E3306D881EDB4F,
+    0x4AE7D6A36EB5DBCB, 0x2D8D5432157064C8, 0xD1E649DE1E7F268B, 0x8A328A1CEDFE552C,
+    0x07A3AEC79624C7DA, 0x84547DDC3E203C94, 0x990A98FD5071D263, 0x1A4FF12616EEFC89,
+    0xF6F7FD1431714200, 0x30C05B1BA332F41C, 0x8D2636B81555A786, 0x46C9FEB55D120902,
+    0xCCEC0A73B49C9921, 0x4E9D2827355FC492, 0x19EBB029435DCB0F, 0x4659D2B743848A2C,
+    0x963EF2C96B33BE31, 0x74F85198B05A2E7D, 0x5A0F544DD2B1FB18, 0x03727073C2E134B1,
+    0xC7F6AA2DE59AEA61, 0x352787BAA0D7C22F, 0x9853EAB63B5E0B35, 0xABBDCDD7ED5C0860,
+    0xCF05DAF5AC8D77B0, 0x49CAD48CEBF4A71E, 0x7A4C10EC2158C4A6, 0xD9E92AA246BF719E,
+    0x13AE978D09FE5557, 0x730499AF921549FF, 0x4E4B705B92903BA4, 0xFF577222C14F0A3A,
+    0x55B6344CF97AAFAE, 0xB862225B055B6960, 0xCAC09AFBDDD2CDB4, 0xDAF8E9829FE96B5F,
+    0xB5FDFC5D3132C498, 0x310CB380DB6F7503, 0xE87FBB46217A360E, 0x2102AE466EBB1148,
+    0xF8549E1A3AA5E00D, 0x07A69AFDCC42261A, 0xC4C118BFE78FEAAE, 0xF9F4892ED96BD438,
+    0x1AF3DBE25D8F45DA, 0xF5B4B0B0D2DEEEB4, 0x962ACEEFA82E1C84, 0x046E3ECAAF453CE9,
+    0xF05D129681949A4C, 0x964781CE734B3C84, 0x9C2ED44081CE5FBD, 0x522E23F3925E319E,
+    0x177E00F9FC32F791, 0x2BC60A63A6F3B3F2, 0x222BBFAE61725606, 0x486289DDCC3D6780,
+    0x7DC7785B8EFDFC80, 0x8AF38731C02BA980, 0x1FAB64EA29A2DDF7, 0xE4D9429322CD065A,
+    0x9DA058C67844F20C, 0x24C0E332B70019B0, 0x233003B5A6CFE6AD, 0xD586BD01C5C217F6,
+    0x5E5637885F29BC2B, 0x7EBA726D8C94094B, 0x0A56A5F0BFE39272, 0xD79476A84EE20D06,
+    0x9E4C1269BAA4BF37, 0x17EFEE45B0DEE640, 0x1D95B0A5FCF90BC6, 0x93CBE0B699C2585D,
+    0x65FA4F227A2B6D79, 0xD5F9E858292504D5, 0xC2B5A03F71471A6F, 0x59300222B4561E00,
+    0xCE2F8642CA0712DC, 0x7CA9723FBB2E8988, 0x2785338347F2BA08, 0xC61BB3A141E50E8C,
+    0x150F361DAB9DEC26, 0x9F6A419D382595F4, 0x64A53DC924FE7AC9, 0x142DE49FFF7A7C3D,
+    0x0C335248857FA9E7, 0x0A9C32D5EAE45305, 0xE6C42178C4BBB92E, 0x71F1CE2490D20B07,
+    0xF1BCC3D275AFE51A, 0xE728E8C83C334074, 0x96FBF83A12884624, 0x81A1549FD6573DA5,
+    0x5FA7867CAF35E149, 0x56986E2EF3ED091B, 0x917F1DD5F8886C61, 0xD20D8C88C8FFE65F,
+    0x31D71DCE64B2C310, 0xF165B587DF898190, 0xA57E6339DD2CF3A0, 0x1EF6E6DBB1961EC9,
+    0x70CC73D90BC26E24, 0xE21A6B35DF0C3AD7, 0x003A93D8B2806962, 0x1C99DED33CB890A1,
+    0xCF3145DE0ADD4289, 0xD0E4427A5514FB72, 0x77C621CC9FB3A483, 0x67A34DAC4356550B,
+    0xF8D626AAAF278509
+};
+
+bool MappedFile::open(const string& path){
+    close();
+#ifdef _WIN32
+    HANDLE f = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                           OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if(f==INVALID_HANDLE_VALUE) return false;
+    file = f;
+    LARGE_INTEGER sz;
+    if(!GetFileSizeEx(f, &sz) || sz.QuadPart==0){ close(); return false; }
+    mapping = CreateFileMappingA(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(!mapping){ close(); return false; }
+    ptr = (const uint8_t*)MapViewOfFile((HANDLE)mapping, FILE_MAP_READ, 0, 0, 0);
+    if(!ptr){ close(); return false; }
+    len = (size_t)sz.QuadPart;
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd<0) return false;
+    struct stat st;
+    if(fstat(fd, &st)!=0 || st.st_size==0){ ::close(fd); return false; }
+    void* p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if(p==MAP_FAILED) return false;
+    madvise(p, (size_t)st.st_size, MADV_RANDOM);
+    ptr = (const uint8_t*)p;
+    len = (size_t)st.st_size;
+#endif
+    return true;
+}
+
+void MappedFile::close(){
+#ifdef _WIN32
+    if(ptr) UnmapViewOfFile(ptr);
+    if(mapping) CloseHandle((HANDLE)mapping);
+    if(file) CloseHandle((HANDLE)file);
+#else
+    if(ptr) munmap((void*)ptr, len);
+#endif
+    ptr=nullptr; len=0;
+    file=mapping=nullptr;
+}
+
+// ============ TT ============
+// Maior potência de 2 de entradas que cabe em mb megabytes.
+static size_t ttEntriesFor(size_t mb){
+    size_t n = 1;
+    while(n*2*sizeof(TTEntry) <= (mb<<20)) n<<=1;
+    return n;
+}
+
+void DeepBeckyEngine::resizeTT(size_t mb){
+    mb = max<size_t>(1, min<size_t>(mb, MAX_HASH_MB));
+    size_t n = ttEntriesFor(mb);
+    if(!tt_mem || n!=tt_mask+1){
+        tt_mem.reset();
+        tt_mem = make_unique<TTEntry[]>(n);
+        tt = tt_mem.get();
+        tt_mask = n-1;
+    }else{
+        clearTT();
+    }
+    hash_mb = mb;
+}
+
+// Servidor: a fatia de hash de cada partida muda com o número de partidas.
+// As entradas vão para key & novo_mask; na colisão fica a mais profunda.
+void DeepBeckyEngine::rehashTT(size_t mb){
+    mb = max<size_t>(1, min<size_t>(mb, MAX_HASH_MB));
+    size_t n = ttEntriesFor(mb);
+    hash_mb = mb;
+    if(tt_mem && n==tt_mask+1) return;
+    unique_ptr<TTEntry[]> old = move(tt_mem);
+    size_t oldN = old? tt_mask+1 : 0;
+    tt_mem = make_unique<TTEntry[]>(n);
+    tt = tt_mem.get();
+    tt_mask = n-1;
+    for(size_t i=0;i<oldN;i++){
+        const TTEntry& o = old[i];
+        if(!o.key) continue;
+        TTEntry& d = tt[o.key & tt_mask];
+        if(!d.key || o.depth > d.depth) d = o;
+    }
+}
+
+// ============ TT em arquivo ============
+static uint64_t zobristPrint(){
+    uint64_t h = ZOB.side;
+    for(int p=0;p<13;p++) h = (h ^ ZOB.piece[p][p*5 % 64]) * 0x100000001B3ULL;
+    return h ^ ZOB.castling[15] ^ ZOB.ep[8];
+}
+
+// Checksum por palavras de 64 bits (a entrada tem alinhamento de 8).
+static uint64_t ttChecksum(uint64_t h, const uint8_t* p, size_t n){
+    static_assert(sizeof(TTEntry)%8==0, "TTEntry must be a multiple of 8 bytes");
+    for(size_t i=0;i<n;i+=8){
+        uint64_t w; memcpy(&w, p+i, 8);
+        h = (h ^ w) * 0x9E3779B97F4A7C15ULL;
+        h ^= h >> 29;
+    }
+    return h;
+}
+
+static TTFileHeader ttHeader(size_t entries){
+    TTFileHeader h{};
+    memcpy(h.magic, "DBHASH\0\0", 8);
+    h.version = TT_FILE_VERSION;
+    h.entry_size = (uint32_t)sizeof(TTEntry);
+    h.entries = entries;
+    h.zobrist = zobristPrint();
+    return h;
+}
+
+bool DeepBeckyEngine::saveTT(const string& path, string& err) const{
+    ofstream out(path, ios::binary);
+    if(!out){ err = "cannot write " + path; return false; }
+    size_t n = tt_mask+1;
+    TTFileHeader h = ttHeader(n);
+    out.write((const char*)&h, sizeof(h)); // checksum reescrito no fim
+    const uint8_t* p = (const uint8_t*)tt;
+    const size_t CHUNK = size_t(1)<<22;
+    uint64_t sum = h.entries;
+    for(size_t off=0, len=n*sizeof(TTEntry); off<len; off+=CHUNK){
+        size_t c = min(CHUNK, len-off);
+        sum = ttChecksum(sum, p+off, c);
+        out.write((const char*)p+off, (streamsize)c);
+    }
+    h.checksum = sum;
+    out.seekp(0);
+    out.write((const char*)&h, sizeof(h));
+    if(!out){ err = "write error on " + path; return false; }
+    return true;
+}
+
+// O arquivo é mapeado só para leitura, validado por inteiro e então copiado
+// para a TT (que passa a ter o tamanho do arquivo).
+bool DeepBeckyEngine::loadTT(const string& path, string& err){
+    MappedFile mf;
+    if(!mf.open(path)){ err = "cannot open " + path; return false; }
+    if(mf.size() < sizeof(TTFileHeader)){ err = "not a hash file"; return false; }
+    TTFileHeader h;
+    memcpy(&h, mf.data(), sizeof(h));
+    TTFileHeader want = ttHeader(h.entries);
+    if(memcmp(h.magic, want.magic, 8)) { err = "not a hash file"; return false; }
+    if(h.version!=want.version)        { err = "unsupported hash file version " + to_string(h.version); return false; }
+    if(h.entry_size!=want.entry_size || h.zobrist!=want.zobrist){ err = "hash file from an incompatible build"; return false; }
+    if(!h.entries || (h.entries & (h.entries-1)) || h.entries*sizeof(TTEntry) > (size_t(MAX_HASH_MB)<<20)
+       || mf.size() != sizeof(h) + h.entries*sizeof(TTEntry)){ err = "bad hash file size"; return false; }
+    const uint8_t* data = mf.data() + sizeof(h);
+    if(ttChecksum(h.entries, data, (size_t)h.entries*sizeof(TTEntry)) != h.checksum){ err = "hash file checksum mismatch"; return false; }
+
+    size_t n = (size_t)h.entries;
+    if(n!=tt_mask+1){
+        tt_mem.reset();
+        tt_mem = make_unique<TTEntry[]>(n);
+        tt = tt_mem.get();
+        tt_mask = n-1;
+        hash_mb = (n*sizeof(TTEntry) + (1<<20) - 1) >> 20;
+    }
+    memcpy((void*)tt, data, n*sizeof(TTEntry));
+    return true;
+}
+
+// ============ Hash corrente ============
+uint64_t DeepBeckyEngine::computeHash() const {
+    uint64_t h=0;
+    for(int y=0;y<8;y++)for(int x=0;x<8;x++){
+        int p=b[y][x]; if(p) h^=ZOB.piece[p][sq(x,y)];
+    }
+    if(!white_to_move) h^=ZOB.side;
+    h^=ZOB.castling[castling&15];
+    h^=ZOB.ep[ep_file&15];
+    return h;
+}
+
+// ============ Chave Polyglot ============
+uint64_t DeepBeckyEngine::polyglotKey() const {
+    uint64_t k=0;
+    for(int y=0;y<8;y++)for(int x=0;x<8;x++){
+        int p=b[y][x]; if(!p) continue;
+        // tipos Polyglot: peão preto=0, peão branco=1, cavalo preto=2, ...
+        int kind = isWhitePiece(p)? 2*(p-WPAWN)+1 : 2*(p-BPAWN);
+        k ^= POLYGLOT_RANDOM[64*kind + 8*y + x];
+    }
+    if(castling&0b1000) k ^= POLYGLOT_RANDOM[768];
+    if(castling&0b0100) k ^= POLYGLOT_RANDOM[769];
+    if(castling&0b0010) k ^= POLYGLOT_RANDOM[770];
+    if(castling&0b0001) k ^= POLYGLOT_RANDOM[771];
+    // EP só entra se houver peão do lado a jogar pronto para capturar
+    if(ep_file){
+        int ex=ep_file-1, y = white_to_move? 4:3, pawn = white_to_move? WPAWN:BPAWN;
+        if((ex>0 && b[y][ex-1]==pawn) || (ex<7 && b[y][ex+1]==pawn))
+            k ^= POLYGLOT_RANDOM[772 + ex];
+    }
+    if(white_to_move) k ^= POLYGLOT_RANDOM[780];
+    return k;
+}
+
+// Escolha ponderada pelo peso entre os lances do livro que são legais aqui
+bool DeepBeckyEngine::probePolyglot(const vector<Move>& root, Move& out){
+    if(!polyglot.isOpen()) return false;
+    vector<PolyglotEntry> entries;
+    polyglot.probe(polyglotKey(), entries);
+
+    vector<pair<Move,uint32_t>> cands;
+    uint64_t total=0;
+    for(const auto& e: entries){
+        int tx=e.move&7, ty=(e.move>>3)&7, fx=(e.move>>6)&7, fy=(e.move>>9)&7, pr=(e.move>>12)&7;
+        // roque codificado como "rei captura a própria torre"
+        int kp=b[fy][fx];
+        if((kp==WKING||kp==BKING) && fx==4){
+            if(tx==7) tx=6;
+            else if(tx==0) tx=2;
+        }
+        for(const auto& r: root){
+            if(r.from_x!=fx || r.from_y!=fy || r.to_x!=tx || r.to_y!=ty) continue;
+            static const int PROMO[5]={0, WKNIGHT, WBISHOP, WROOK, WQUEEN};
+            int want = pr? (white_to_move? PROMO[pr] : PROMO[pr]+6) : 0;
+            if(r.promotion!=want) continue;
+            uint32_t w = max<uint32_t>(1, e.weight);
+            cands.push_back({r, w}); total+=w;
+            break;
+        }
+    }
+    if(cands.empty()) return false;
+    uint64_t pick = book_rng() % total;
+    for(const auto& c: cands){
+        if(pick < c.second){ out=c.first; return true; }
+        pick -= c.second;
+    }
+    out=cands.back().first;
+    return true;
+}
+
+// ============ Empate por repetição / 50 lances ============
+// Varre a pilha de hashes para trás só dentro dos últimos `halfmove` plies
+// (antes disso houve lance irreversível) e só na mesma vez de jogar.
+// Repetição dentro do caminho da busca já conta como empate; contra o
+// histórico anterior à raiz exige-se a terceira ocorrência.
+bool DeepBeckyEngine::isDraw(int ply){
+    if(halfmove>=100){
+        if(!inCheck(white_to_move)) return true;
+        return !generateLegal().empty(); // mate tem prioridade sobre a regra dos 50
+    }
+    int n = (int)hash_history.size();
+    int lim = min(halfmove, n);
+    int reps = 0;
+    for(int i=4; i<=lim; i+=2){
+        if(hash_history[n-i]!=hash) continue;
+        if(i<=ply) return true;
+        if(++reps>=2) return true;
+    }
+    return false;
+}
+
+// Sem peões, torres ou damas e no máximo uma peça menor no tabuleiro: nenhum
+// lado consegue dar mate (usado na adjudicação de partidas).
+bool DeepBeckyEngine::insufficientMaterial() const {
+    int minors=0;
+    for(int y=0;y<8;y++) for(int x=0;x<8;x++){
+        int p=b[y][x];
+        if(p==EMPTY || p==WKING || p==BKING) continue;
+        if(p==WKNIGHT || p==WBISHOP || p==BKNIGHT || p==BBISHOP){ if(++minors>1) return false; }
+        else return false;
+    }
+    return true;
+}
+
+// ============ Posição inicial ============
+void DeepBeckyEngine::setStartPos(){
+    const int rowW[8]={WROOK,WKNIGHT,WBISHOP,WQUEEN,WKING,WBISHOP,WKNIGHT,WROOK};
+    const int rowB[8]={BROOK,BKNIGHT,BBISHOP,BQUEEN,BKING,BBISHOP,BKNIGHT,BROOK};
+    memset(b,0,sizeof(b));
+    for(int x=0;x<8;x++){ b[0][x]=rowW[x]; b[1][x]=WPAWN; b[6][x]=BPAWN; b[7][x]=rowB[x]; }
+    white_to_move=true; castling=0b1111; ep_file=0; halfmove=0; fullmove=1;
+    uci_history.clear();
+    hash_history.clear();
+    hash=computeHash();
+    men=0;
+    for(int y=0;y<8;y++) for(int x=0;x<8;x++) men += b[y][x]!=EMPTY;
+}
+
+// ============ FEN ============
+void DeepBeckyEngine::setFEN(const string &fen){
+    // Suporta campos: peças, side, roques, ep, halfmove, fullmove
+    memset(b,0,sizeof(b));
+    stringstream ss(fen); string piece, side, castl, ep; int hm=0, fm=1;
+    ss>>piece>>side>>castl>>ep>>hm>>fm;
+    int x=0,y=7;
+    for(char c:piece){
+        if(c=='/') { y--; x=0; continue; }
+        if(isdigit((unsigned char)c)){ x+= c - '0'; continue; }
+        int p=EMPTY;
+        switch(c){
+            case 'P': p=WPAWN; break; case 'N': p=WKNIGHT; break; case 'B': p=WBISHOP; break;
+            case 'R': p=WROOK; break; case 'Q': p=WQUEEN; break; case 'K': p=WKING; break;
+            case 'p': p=BPAWN; break; case 'n': p=BKNIGHT; break; case 'b': p=BBISHOP; break;
+            case 'r': p=BROOK; break; case 'q': p=BQUEEN; break; case 'k': p=BKING; break;
+        }
+        if(p!=EMPTY && x<8 && y>=0){ b[y][x]=p; x++; }
+    }
+    white_to_move = (side=="w");
+    castling=0;
+    if(castl.find('K')!=string::npos) castling|=0b1000;
+    if(castl.find('Q')!=string::npos) castling|=0b0100;
+    if(castl.find('k')!=string::npos) castling|=0b0010;
+    if(castl.find('q')!=string::npos) castling|=0b0001;
+    ep_file=0;
+    if(ep!="-" && ep.size()==2){ ep_file = (ep[0]-'a')+1; }
+    halfmove=hm; fullmove=fm;
+    uci_history.clear();
+    hash_history.clear();
+    hash=computeHash();
+    men=0;
+    for(int y=0;y<8;y++) for(int x=0;x<8;x++) men += b[y][x]!=EMPTY;
+}
+
+string DeepBeckyEngine::getFEN() const {
+    static const char PC[] = " PNBRQKpnbrqk";
+    string f;
+    for(int y=7;y>=0;y--){
+        int empty=0;
+        for(int x=0;x<8;x++){
+            int p=b[y][x];
+            if(!p){ empty++; continue; }
+            if(empty){ f+=char('0'+empty); empty=0; }
+            f+=PC[p];
+        }
+        if(empty) f+=char('0'+empty);
+        if(y) f+='/';
+    }
+    f += white_to_move? " w " : " b ";
+    string c;
+    if(castling&0b1000) c+='K';
+    if(castling&0b0100) c+='Q';
+    if(castling&0b0010) c+='k';
+    if(castling&0b0001) c+='q';
+    f += c.empty()? "-" : c;
+    if(ep_file){ f += ' '; f += char('a'+ep_file-1); f += white_to_move? '6' : '3'; }
+    else f += " -";
+    f += " " + to_string(halfmove) + " " + to_string(fullmove);
+    return f;
+}
+
+// ============ Posição empacotada ============
+PackedPos DeepBeckyEngine::pack(int score, const Move& m, int result) const {
+    PackedPos p{};
+    int n=0;
+    for(int i=0;i<64;i++){
+        int pc = b[i>>3][i&7];
+        if(!pc || n>=32) continue;
+        p.occupied |= 1ULL<<i;
+        p.pieces[n>>1] |= (uint8_t)(pc << ((n&1)*4));
+        n++;
+    }
+    p.score = (int16_t)max(-32000, min(32000, score));
+    p.move = packMove(m);
+    p.flags = (uint8_t)((white_to_move? 0:1) | (castling<<1));
+    p.ep = (uint8_t)ep_file;
+    p.halfmove = (uint8_t)min(halfmove, 255);
+    p.result = (int8_t)result;
+    return p;
+}
+
+void DeepBeckyEngine::unpack(const PackedPos& p){
+    memset(b,0,sizeof(b));
+    int n=0;
+    for(int i=0;i<64;i++){
+        if(!(p.occupied>>i & 1)) continue;
+        b[i>>3][i&7] = (p.pieces[n>>1] >> ((n&1)*4)) & 15;
+        n++;
+    }
+    white_to_move = !(p.flags&1);
+    castling = (p.flags>>1) & 15;
+    ep_file = p.ep;
+    halfmove = p.halfmove; fullmove = 1;
+    uci_history.clear();
+    hash_history.clear();
+    hash=computeHash();
+    men=0;
+    for(int y=0;y<8;y++) for(int x=0;x<8;x++) men += b[y][x]!=EMPTY;
+}
+
+bool SfenWriter::open(const string& path, bool append){
+    close();
+    out.open(path, ios::binary | (append? ios::app : ios::trunc));
+    written = 0;
+    return (bool)out;
+}
+
+void SfenWriter::write(const PackedPos* p, size_t n){
+    lock_guard<mutex> lk(mx);
+    out.write((const char*)p, n*sizeof(PackedPos));
+    written += (long long)n;
+}
+
+void SfenWriter::close(){
+    lock_guard<mutex> lk(mx);
+    if(out.is_open()) out.close();
+}
+
+bool SfenReader::open(const string& path){
+    in.close(); in.clear();
+    in.open(path, ios::binary);
+    buf.resize(1<<14);
+    pos = len = 0;
+    return (bool)in;
+}
+
+bool SfenReader::next(PackedPos& p){
+    if(pos==len){
+        in.read((char*)buf.data(), buf.size()*sizeof(PackedPos));
+        len = (size_t)in.gcount() / sizeof(PackedPos);
+        pos = 0;
+        if(!len) return false;
+    }
+    p = buf[pos++];
+    return true;
+}
+
+// ============ Cheque/ataque ============
+static const int KING_DX[8]={1,1,1,0,0,-1,-1,-1};
+static const int KING_DY[8]={1,0,-1,1,-1,1,0,-1};
+static const int KNIGHT_DX[8]={1,2,2,1,-1,-2,-2,-1};
+static const int KNIGHT_DY[8]={2,1,-1,-2,-2,-1,1,2};
+
+// Casa (x,y) atacada por alguma peça do lado Us.
+template<int Us>
+bool DeepBeckyEngine::attackedBy(int x, int y) const {
+    typedef SideOf<Us> S;
+    // peão de Us ataca para frente: está uma fileira atrás da casa
+    int py = y - S::FWD;
+    if(py>=0 && py<8){
+        if(x>0 && b[py][x-1]==S::PAWN) return true;
+        if(x<7 && b[py][x+1]==S::PAWN) return true;
+    }
+    for(int i=0;i<8;i++){
+        int nx=x+KNIGHT_DX[i], ny=y+KNIGHT_DY[i];
+        if(onBoard(nx,ny) && b[ny][nx]==S::KNIGHT) return true;
+    }
+    for(int i=0;i<8;i++){
+        int nx=x+KING_DX[i], ny=y+KING_DY[i];
+        if(onBoard(nx,ny) && b[ny][nx]==S::KING) return true;
+    }
+    // deslizantes
+    for(int dx=-1; dx<=1; ++dx) for(int dy=-1; dy<=1; ++dy){
+        if(dx==0 && dy==0) continue;
+        int slider = (dx==0||dy==0)? S::ROOK : S::BISHOP;
+        int nx=x+dx, ny=y+dy;
+        while(onBoard(nx,ny)){
+            int p=b[ny][nx];
+            if(p){
+                if(p==slider || p==S::QUEEN) return true;
+                break;
+            }
+            nx+=dx; ny+=dy;
+        }
+    }
+    return false;
+}
+
+template<int Us>
+bool DeepBeckyEngine::kingAttacked() const {
+    for(int y=0;y<8;y++) for(int x=0;x<8;x++)
+        if(b[y][x]==SideOf<Us>::KING) return attackedBy<SideOf<Us>::Them>(x,y);
+    return false;
+}
+
+bool DeepBeckyEngine::isAttacked(int x,int y,bool byWhite){
+    return byWhite? attackedBy<WHITE>(x,y) : attackedBy<BLACK>(x,y);
+}
+
+bool DeepBeckyEngine::inCheck(bool whiteSide){
+    return whiteSide? kingAttacked<WHITE>() : kingAttacked<BLACK>();
+}
+
+// ============ Legalidade ============
+// Aplica, verifica cheque próprio
+template<int Us>
+bool DeepBeckyEngine::legalFor(const Move& m){
+    if(b[m.from_y][m.from_x]==EMPTY) return false;
+    doMove<Us>(m);
+    bool ok = !kingAttacked<Us>();
+    undoMoveFor<Us>(m);
+    return ok;
+}
+
+bool DeepBeckyEngine::legalMove(const Move& m){
+    return white_to_move? legalFor<WHITE>(m) : legalFor<BLACK>(m);
+}
+
+// ============ Gerar movimentos ============
+// Geração simples e correta, com EP, roques e promoções
+template<int Us>
+void DeepBeckyEngine::genPseudo(vector<Move>& mv, bool capturesOnly){
+    typedef SideOf<Us> S;
+    typedef SideOf<S::Them> O;
+
+    auto add=[&](int fx,int fy,int tx,int ty, bool cap=false, int capPiece=EMPTY, bool ep=false, bool castle=false, bool dbl=false, int promo=0){
+        Move m; m.from_x=fx; m.from_y=fy; m.to_x=tx; m.to_y=ty; m.is_capture=cap; m.captured_piece=capPiece;
+        m.is_enpassant=ep; m.is_castle=castle; m.is_doublepush=dbl; m.promotion=promo; mv.push_back(m);
+    };
+    auto addPromos=[&](int fx,int fy,int tx,int ty, bool cap, int capPiece){
+        add(fx,fy,tx,ty,cap,capPiece,false,false,false,S::QUEEN);
+        add(fx,fy,tx,ty,cap,capPiece,false,false,false,S::ROOK);
+        add(fx,fy,tx,ty,cap,capPiece,false,false,false,S::BISHOP);
+        add(fx,fy,tx,ty,cap,capPiece,false,false,false,S::KNIGHT);
+    };
+    auto isOpp=[](int t){ return t>=O::FIRST && t<=O::LAST; };
+
+    for(int y=0;y<8;y++) for(int x=0;x<8;x++){
+        int p=b[y][x];
+        if(p<S::FIRST || p>S::LAST) continue;
+
+        switch(p){
+            case S::PAWN:{
+                int ny=y + S::FWD;
+                if(ny<0 || ny>7) break; // peão na última fileira (FEN inválido)
+                if(b[ny][x]==EMPTY && !capturesOnly){
+                    if(y==S::PROMO_Y){
+                        addPromos(x,y,x,ny,false,0);
+                    }else{
+                        add(x,y,x,ny,false,0,false,false,false,0);
+                        // duplo
+                        if(y==S::START_Y){
+                            int nny=y + 2*S::FWD;
+                            if(b[nny][x]==EMPTY) add(x,y,x,nny,false,0,false,false,true,0);
+                        }
+                    }
+                }
+                // capturas
+                for(int dx=-1; dx<=1; dx+=2){
+                    int nx=x+dx;
+                    if(nx<0 || nx>7) continue;
+                    int t=b[ny][nx];
+                    if(isOpp(t)){
+                        if(y==S::PROMO_Y) addPromos(x,y,nx,ny,true,t);
+                        else add(x,y,nx,ny,true,t,false,false,false,0);
+                    }
+                }
+                // en passant
+                if(ep_file>=1 && ep_file<=8 && y==S::EP_Y){
+                    int ex = ep_file-1;
+                    if(abs(ex-x)==1 && b[y][ex]==O::PAWN)
+                        add(x,y,ex,ny,true,O::PAWN,true,false,false,0);
+                }
+            }break;
+
+            case S::KNIGHT:{
+                for(int i=0;i<8;i++){
+                    int nx=x+KNIGHT_DX[i], ny=y+KNIGHT_DY[i];
+                    if(!onBoard(nx,ny)) continue;
+                    int t=b[ny][nx];
+                    if(t==EMPTY && !capturesOnly) add(x,y,nx,ny,false,0,false,false,false,0);
+                    else if(isOpp(t)) add(x,y,nx,ny,true,t,false,false,false,0);
+                }
+            }break;
+
+            case S::BISHOP:
+            case S::ROOK:
+            case S::QUEEN:{
+                static const int DIRS[8][2]={{1,0},{-1,0},{0,1},{0,-1},{1,1},{-1,1},{1,-1},{-1,-1}};
+                int start = p==S::BISHOP? 4 : 0;
+                int end   = p==S::ROOK? 4 : 8;
+                for(int d=start; d<end; ++d){
+                    int dx=DIRS[d][0], dy=DIRS[d][1];
+                    int nx=x+dx, ny=y+dy;
+                    while(onBoard(nx,ny)){
+                        int t=b[ny][nx];
+                        if(t==EMPTY){
+                            if(!capturesOnly) add(x,y,nx,ny,false,0,false,false,false,0);
+                        }else{
+                            if(isOpp(t)) add(x,y,nx,ny,true,t,false,false,false,0);
+                            break;
+                        }
+                        nx+=dx; ny+=dy;
+                    }
+                }
+            }break;
+
+            case S::KING:{
+                for(int i=0;i<8;i++){
+                    int nx=x+KING_DX[i], ny=y+KING_DY[i];
+                    if(!onBoard(nx,ny)) continue;
+                    int t=b[ny][nx];
+                    if(t==EMPTY && !capturesOnly) add(x,y,nx,ny,false,0,false,false,false,0);
+                    else if(isOpp(t)) add(x,y,nx,ny,true,t,false,false,false,0);
+                }
+                // Roques
+                const int ry = S::HOME_Y;
+                if(!capturesOnly && y==ry && x==4 && (castling & (S::CASTLE_K|S::CASTLE_Q))
+                   && !attackedBy<S::Them>(4,ry)){
+                    if((castling & S::CASTLE_K) && b[ry][5]==EMPTY && b[ry][6]==EMPTY &&
+                       !attackedBy<S::Them>(5,ry) && !attackedBy<S::Them>(6,ry))
+                        add(4,ry,6,ry,false,0,false,true,false,0);
+                    if((castling & S::CASTLE_Q) && b[ry][3]==EMPTY && b[ry][2]==EMPTY && b[ry][1]==EMPTY &&
+                       !attackedBy<S::Them>(3,ry) && !attackedBy<S::Them>(2,ry))
+                        add(4,ry,2,ry,false,0,false,true,false,0);
+                }
+            }break;
+        }
+    }
+}
+
+template<int Us>
+vector<Move> DeepBeckyEngine::genLegal(bool capturesOnly){
+    vector<Move> mv; mv.reserve(64);
+    genPseudo<Us>(mv, capturesOnly);
+    vector<Move> legal; legal.reserve(mv.size());
+    for(auto &m: mv) if(legalFor<Us>(m)) legal.push_back(m);
+    return legal;
+}
+
+vector<Move> DeepBeckyEngine::generatePseudo(bool capturesOnly){
+    vector<Move> mv; mv.reserve(64);
+    if(white_to_move) genPseudo<WHITE>(mv, capturesOnly);
+    else              genPseudo<BLACK>(mv, capturesOnly);
+    return mv;
+}
+
+vector<Move> DeepBeckyEngine::generateLegal(bool capturesOnly){
+    return white_to_move? genLegal<WHITE>(capturesOnly) : genLegal<BLACK>(capturesOnly);
+}
+
+// ============ Aplicar/Desfazer ============
+template<int Us>
+void DeepBeckyEngine::doMove(const Move& m){
+    typedef SideOf<Us> S;
+    typedef SideOf<S::Them> O;
+    Undo u;
+    u.captured = m.is_enpassant? O::PAWN : b[m.to_y][m.to_x];
+    if(u.captured!=EMPTY) men--;
+    u.castling_before = castling;
+    u.ep_before = ep_file;
+    u.half_before = halfmove;
+    u.full_before = fullmove;
+    u.side_before = Us==WHITE;
+    u.hash_before = hash;
+    undo.push_back(u);
+    hash_history.push_back(hash);
+
+    int piece = b[m.from_y][m.from_x];
+    int target= b[m.to_y][m.to_x];
+
+    // atualizar EP: válido somente após duplo-peão
+    ep_file = 0;
+
+    // move a peça
+    b[m.from_y][m.from_x]=EMPTY;
+    b[m.to_y][m.to_x]=piece;
+
+    if(m.is_enpassant){
+        b[m.to_y - S::FWD][m.to_x]=EMPTY;
+    }else if(m.is_castle){
+        // mover torre
+        if(m.to_x==6){ // roque pequeno
+            b[m.to_y][5] = S::ROOK;
+            b[m.to_y][7] = EMPTY;
+        }else if(m.to_x==2){ // roque grande
+            b[m.to_y][3] = S::ROOK;
+            b[m.to_y][0] = EMPTY;
+        }
+    }
+
+    // promoção
+    if(m.promotion){
+        b[m.to_y][m.to_x] = m.promotion;
+    }
+
+    // duplo avanço de peão cria EP
+    if(m.is_doublepush){
+        ep_file = m.from_x+1;
+    }
+
+    // atualizar roques: rei ou torre próprios saindo de casa, torre adversária capturada em casa
+    if(piece==S::KING) castling &= ~(S::CASTLE_K|S::CASTLE_Q);
+    if(piece==S::ROOK && m.from_y==S::HOME_Y){
+        if(m.from_x==0) castling &= ~S::CASTLE_Q;
+        if(m.from_x==7) castling &= ~S::CASTLE_K;
+    }
+    if(target==O::ROOK && m.to_y==O::HOME_Y){
+        if(m.to_x==0) castling &= ~O::CASTLE_Q;
+        if(m.to_x==7) castling &= ~O::CASTLE_K;
+    }
+
+    // meia-jogada / jogada cheia
+    if(piece==S::PAWN || m.is_capture) halfmove=0;
+    else halfmove++;
+    if(Us==BLACK) fullmove++;
+
+    // troca a vez
+    white_to_move = Us==BLACK;
+
+    // atualiza hash
+    hash = computeHash();
+
+    // histórico UCI para book/repetição
+    // (adiciona apenas lances realmente feitos)
+    uci_history.push_back(moveToUCI(m));
+}
+
+// Us = lado que fez o lance
+template<int Us>
+void DeepBeckyEngine::undoMoveFor(const Move& m){
+    typedef SideOf<Us> S;
+    Undo u = undo.back(); undo.pop_back();
+    if(u.captured!=EMPTY) men++;
+    white_to_move = u.side_before;
+    castling = u.castling_before;
+    ep_file  = u.ep_before;
+    halfmove = u.half_before;
+    fullmove = u.full_before;
+    hash     = u.hash_before;
+    if(!hash_history.empty()) hash_history.pop_back();
+
+    int piece = b[m.to_y][m.to_x];
+
+    if(m.is_enpassant){
+        // Restaura peão original e o capturado, uma fileira atrás do destino
+        b[m.from_y][m.from_x] = piece;
+        b[m.to_y][m.to_x] = EMPTY;
+        b[m.to_y - S::FWD][m.to_x] = u.captured;
+    }else if(m.is_castle){
+        // Rei de volta; torre de f/d para h/a
+        b[m.to_y][m.to_x] = EMPTY;
+        b[m.from_y][m.from_x] = S::KING;
+        if(m.to_x==6){
+            b[m.from_y][5] = EMPTY;
+            b[m.from_y][7] = S::ROOK;
+        }else{
+            b[m.from_y][3] = EMPTY;
+            b[m.from_y][0] = S::ROOK;
+        }
+    }else{
+        // Movimento normal ou promoção
+        b[m.from_y][m.from_x] = m.promotion? S::PAWN : piece;
+        b[m.to_y][m.to_x] = u.captured;
+    }
+
+    if(!uci_history.empty()) uci_history.pop_back();
+}
+
+void DeepBeckyEngine::makeMove(const Move& m){
+    if(white_to_move) doMove<WHITE>(m);
+    else              doMove<BLACK>(m);
+}
+
+void DeepBeckyEngine::undoMove(const Move& m){
+    if(undo.back().side_before) undoMoveFor<WHITE>(m);
+    else                        undoMoveFor<BLACK>(m);
+}
+
+// Lance nulo: só troca a vez. halfmove=0 impede que a busca de repetição
+// atravesse o lance nulo.
+void DeepBeckyEngine::makeNullMove(){
+    Undo u;
+    u.captured = EMPTY;
+    u.castling_before = castling;
+    u.ep_before = ep_file;
+    u.half_before = halfmove;
+    u.full_before = fullmove;
+    u.side_before = white_to_move;
+    u.hash_before = hash;
+    undo.push_back(u);
+    hash_history.push_back(hash);
+
+    ep_file = 0;
+    halfmove = 0;
+    white_to_move = !white_to_move;
+    hash = computeHash();
+}
+
+void DeepBeckyEngine::undoNullMove(){
+    Undo u = undo.back(); undo.pop_back();
+    white_to_move = u.side_before;
+    castling = u.castling_before;
+    ep_file  = u.ep_before;
+    halfmove = u.half_before;
+    fullmove = u.full_before;
+    hash     = u.hash_before;
+    if(!hash_history.empty()) hash_history.pop_back();
+}
+
+bool DeepBeckyEngine::hasNonPawnMaterial(bool whiteSide) const {
+    for(int y=0;y<8;y++) for(int x=0;x<8;x++){
+        int p=b[y][x];
+        if(whiteSide && p>=WKNIGHT && p<=WQUEEN) return true;
+        if(!whiteSide && p>=BKNIGHT && p<=BQUEEN) return true;
+    }
+    return false;
+}
+
+// ============ UCI helpers ============
+string DeepBeckyEngine::moveToUCI(const Move& m) const{
+    auto alg=[&](int x,int y){
+        string s; s.push_back('a'+x); s.push_back('1'+y); return s;
+    };
+    string u = alg(m.from_x,m.from_y) + alg(m.to_x,m.to_y);
+    if(m.promotion){
+        switch(m.promotion){
+            case WQUEEN: case BQUEEN: u+='q'; break;
+            case WROOK : case BROOK : u+='r'; break;
+            case WBISHOP:case BBISHOP:u+='b'; break;
+            case WKNIGHT:case BKNIGHT:u+='n'; break;
+        }
+    }
+    return u;
+}
+
+Move DeepBeckyEngine::uciToMove(const string& s) const{
+    Move m;
+    if(s.size()<4) return m;
+    int fx=s[0]-'a', fy=s[1]-'1';
+    int tx=s[2]-'a', ty=s[3]-'1';
+    if(!onBoard(fx,fy) || !onBoard(tx,ty)) return m;
+    m.from_x=fx; m.from_y=fy; m.to_x=tx; m.to_y=ty; m.promotion=0;
+    if(s.size()>=5){
+        char pc=s[4];
+        if(pc=='q') m.promotion = white_to_move? WQUEEN:BQUEEN;
+        else if(pc=='r') m.promotion = white_to_move? WROOK:BROOK;
+        else if(pc=='b') m.promotion = white_to_move? WBISHOP:BBISHOP;
+        else if(pc=='n') m.promotion = white_to_move? WKNIGHT:BKNIGHT;
+    }
+    return m;
+}
+
+// Lance pseudo-legal com mesma origem/destino/promoção, verificado com um
+// único make/undo (sem gerar a lista legal inteira nem comparar strings).
+bool DeepBeckyEngine::findLegal(const Move& want, Move& out){
+    int p = b[want.from_y][want.from_x];
+    if(p==EMPTY || isWhitePiece(p)!=white_to_move) return false;
+    for(const auto& m: generatePseudo()){
+        if(m.from_x==want.from_x && m.from_y==want.from_y && m.to_x==want.to_x && m.to_y==want.to_y
+           && m.promotion==want.promotion){
+            if(!legalMove(m)) return false;
+            out = m;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ============ Ordenação ============
+void DeepBeckyEngine::scoreMoves(vector<Move>& mv, const Move& ttMove, int ply){
+    auto mvv_lva=[&](const Move& m){
+        int att = b[m.from_y][m.from_x];
+        int def = m.is_enpassant? (white_to_move? BPAWN:WPAWN) : b[m.to_y][m.to_x];
+        return 10*PIECE_VALUE[def] - PIECE_VALUE[att];
+    };
+    int side = white_to_move? 0:1;
+    int prev1 = move_pt[ply+1], prev2 = move_pt[ply];
+    for(auto &m: mv){
+        int sc=0;
+        if( (ttMove.from_x|ttMove.from_y|ttMove.to_x|ttMove.to_y) && m==ttMove) sc += 2'000'000;
+        if(m.is_capture) sc += 1'000'000 + mvv_lva(m);
+        if(m.is_castle) sc += 50'000;
+        if(!m.is_capture){
+            // Killers e counter-move
+            for(int k=0;k<2;k++){
+                const Move& km = heur->killers.killer[k][ply];
+                if((km.from_x|km.from_y|km.to_x|km.to_y) && m==km) sc += 200'000 - 5'000*k;
+            }
+            int from=sq(m.from_x,m.from_y), to=sq(m.to_x,m.to_y);
+            if(prev1>=0 && heur->counter[side][prev1]==from*64+to) sc += 150'000;
+            // History + continuação (1 e 2 plies)
+            int pt = pieceTo(b[m.from_y][m.from_x], to);
+            sc += heur->history[side][from][to];
+            if(prev1>=0) sc += heur->cont[0][prev1][pt];
+            if(prev2>=0) sc += heur->cont[1][prev2][pt];
+        }
+        m.score=sc;
+    }
+    stable_sort(mv.begin(), mv.end(), [](const Move&a,const Move&b){return a.score>b.score;});
+}
+
+// Corte por lance quieto: bônus para o lance, malus para os quietos já
+// tentados antes dele; killers e counter-move apontam para o lance.
+void DeepBeckyEngine::updateQuietStats(const Move& best, const Move* quiets, int nQuiets, int depth, int ply){
+    int side = white_to_move? 0:1;
+    int prev1 = move_pt[ply+1], prev2 = move_pt[ply];
+    int bonus = statBonus(depth);
+    auto upd=[&](const Move& m, int v){
+        int from=sq(m.from_x,m.from_y), to=sq(m.to_x,m.to_y);
+        int pt = pieceTo(b[m.from_y][m.from_x], to);
+        gravity(heur->history[side][from][to], v);
+        if(prev1>=0) gravity(heur->cont[0][prev1][pt], v);
+        if(prev2>=0) gravity(heur->cont[1][prev2][pt], v);
+    };
+    upd(best, bonus);
+    for(int i=0;i<nQuiets;i++) if(!(quiets[i]==best)) upd(quiets[i], -bonus);
+
+    KillerTable& k = heur->killers;
+    if(!(k.killer[0][ply]==best)){
+        k.killer[1][ply] = k.killer[0][ply];
+        k.killer[0][ply] = best;
+    }
+    if(prev1>=0) heur->counter[side][prev1] = (uint16_t)(sq(best.from_x,best.from_y)*64 + sq(best.to_x,best.to_y));
+}
+
+// ============ Bitbase KPK ============
+// Índice: rei forte | rei fraco<<6 | vez<<12 | coluna do peão (a-d)<<13 |
+// (7ª fileira - fileira do peão)<<15. Vez 0 = lado forte.
+enum { KPK_INVALID=0, KPK_UNKNOWN=1, KPK_DRAW=2, KPK_WIN=4 };
+static const int KPK_NB = 2*24*64*64;
+
+static inline int kpkIndex(int stm, int wk, int bk, int p){
+    return wk | bk<<6 | stm<<12 | (p&7)<<13 | (6-(p>>3))<<15;
+}
+static inline int kingDist(int a, int b){ return max(abs((a&7)-(b&7)), abs((a>>3)-(b>>3))); }
+static inline bool pawnHits(int p, int s){ return (s>>3)==(p>>3)+1 && abs((s&7)-(p&7))==1; }
+
+// Casas vizinhas do rei em s; retorna quantas.
+static int kingSteps(int s, int* out){
+    int n=0, x=s&7, y=s>>3;
+    for(int dy=-1;dy<=1;dy++) for(int dx=-1;dx<=1;dx++)
+        if((dx||dy) && onBoard(x+dx, y+dy)) out[n++] = sq(x+dx, y+dy);
+    return n;
+}
+
+KPKBitbase::KPKBitbase(){
+    vector<uint8_t> db(KPK_NB);
+    int to[8];
+    for(int i=0;i<KPK_NB;i++){
+        int wk=i&63, bk=(i>>6)&63, stm=(i>>12)&1, p=((i>>13)&3) + (6-(i>>15))*8;
+        uint8_t r = KPK_UNKNOWN;
+        if(kingDist(wk,bk)<=1 || wk==p || bk==p || (stm==0 && pawnHits(p,bk))) r = KPK_INVALID;
+        // promove sem ser capturado
+        else if(stm==0 && (p>>3)==6 && wk!=p+8 && (kingDist(bk,p+8)>1 || kingDist(wk,p+8)==1)) r = KPK_WIN;
+        else if(stm==1){
+            // afogado ou captura o peão desprotegido
+            bool safe=false;
+            for(int k=0, n=kingSteps(bk, to); k<n && !safe; k++)
+                safe = kingDist(to[k],wk)>1 && !pawnHits(p,to[k]);
+            if(!safe || (kingDist(bk,p)==1 && kingDist(wk,p)>1)) r = KPK_DRAW;
+        }
+        db[i] = r;
+    }
+    for(bool changed=true; changed; ){
+        changed = false;
+        for(int i=0;i<KPK_NB;i++){
+            if(db[i]!=KPK_UNKNOWN) continue;
+            int wk=i&63, bk=(i>>6)&63, stm=(i>>12)&1, p=((i>>13)&3) + (6-(i>>15))*8;
+            int r = KPK_INVALID, good, bad;
+            if(stm==0){
+                good = KPK_WIN; bad = KPK_DRAW;
+                for(int k=0, n=kingSteps(wk, to); k<n; k++) r |= db[kpkIndex(1, to[k], bk, p)];
+                if((p>>3) < 6) r |= db[kpkIndex(1, wk, bk, p+8)];
+                if((p>>3)==1 && p+8!=wk && p+8!=bk) r |= db[kpkIndex(1, wk, bk, p+16)];
+            }else{
+                good = KPK_DRAW; bad = KPK_WIN;
+                for(int k=0, n=kingSteps(bk, to); k<n; k++) r |= db[kpkIndex(0, wk, to[k], p)];
+            }
+            r = (r & good)? good : (r & KPK_UNKNOWN)? KPK_UNKNOWN : bad;
+            if(r!=KPK_UNKNOWN){ db[i] = (uint8_t)r; changed = true; }
+        }
+    }
+    for(int i=0;i<KPK_NB;i++) if(db[i]==KPK_WIN) win[i>>6] |= 1ULL << (i&63);
+}
+
+bool KPKBitbase::probe(bool strongToMove, int strongKing, int pawn, int weakKing) const {
+    if((pawn&7) > 3){ strongKing ^= 7; pawn ^= 7; weakKing ^= 7; } // espelha para a-d
+    int i = kpkIndex(strongToMove? 0:1, strongKing, weakKing, pawn);
+    return win[i>>6] >> (i&63) & 1;
+}
+
+// K+P x K: vitória vale KPK_WIN_SCORE mais o avanço do peão (a busca progride
+// em vez de andar em círculos); empate vale 0. Falso em qualquer outro final
+// de três peças.
+bool DeepBeckyEngine::probeKPK(int& score) const {
+    int wk=-1, bk=-1, p=-1;
+    bool whitePawn=true;
+    for(int y=0;y<8;y++) for(int x=0;x<8;x++){
+        int pc = b[y][x];
+        if(pc==EMPTY) continue;
+        if(pc==WKING) wk=sq(x,y);
+        else if(pc==BKING) bk=sq(x,y);
+        else if(pc==WPAWN || pc==BPAWN){ p=sq(x,y); whitePawn = pc==WPAWN; }
+        else return false;
+    }
+    if(p<0 || wk<0 || bk<0) return false;
+    // lado forte sempre de brancas, peão subindo
+    int sk = whitePawn? wk : bk^56, wkk = whitePawn? bk : wk^56, ps = whitePawn? p : p^56;
+    if((ps>>3)<1 || (ps>>3)>6) return false;
+    bool strongToMove = white_to_move==whitePawn;
+    if(!KPK.probe(strongToMove, sk, ps, wkk)){ score = 0; return true; }
+    int v = KPK_WIN_SCORE + 20*(ps>>3) - 4*kingDist(sk, ps+8);
+    score = strongToMove? v : -v;
+    return true;
+}
+
+// ============ Avaliação ============
+int DeepBeckyEngine::evaluate(){
+    const EvalParams& E = *eval;
+    int mat=0, pst=0;
+    int bishopsW=0, bishopsB=0;
+
+    for(int y=0;y<8;y++) for(int x=0;x<8;x++){
+        int p=b[y][x]; if(!p) continue;
+        int sqi=sq(x,y);
+        if(isWhitePiece(p)){
+            int t=p-WPAWN;
+            if(p==WKING){
+                // rei: média de meio-jogo e final
+                pst += (E.pst(PST_KMG,sqi) + E.pst(PST_KEG,sqi))/2;
+            }else{
+                mat += E.material(t);
+                pst += E.pst(t,sqi);
+                if(p==WBISHOP) bishopsW++;
+            }
+        }else{
+            int t=p-BPAWN, r=56^sqi; // espelha verticalmente
+            if(p==BKING){
+                pst -= (E.pst(PST_KMG,r) + E.pst(PST_KEG,r))/2;
+            }else{
+                mat -= E.material(t);
+                pst -= E.pst(t,r);
+                if(p==BBISHOP) bishopsB++;
+            }
+        }
+    }
+
+    int score = mat + pst;
+
+    // par de bispos
+    if(bishopsW>=2) score += E.v[EP_BISHOP_PAIR];
+    if(bishopsB>=2) score -= E.v[EP_BISHOP_PAIR];
+
+    // mobilidade simples
+    int mob=0;
+    for(int y=0;y<8;y++)for(int x=0;x<8;x++){
+        int p=b[y][x]; if(!p) continue;
+        if(p==WROOK||p==WQUEEN){
+            int c=0;
+            static const int D[4][2]={{1,0},{-1,0},{0,1},{0,-1}};
+            for(auto &d:D){
+                int nx=x+d[0], ny=y+d[1];
+                while(onBoard(nx,ny) && b[ny][nx]==EMPTY){ c++; nx+=d[0]; ny+=d[1]; }
+            }
+            mob += E.v[EP_MOBILITY]*c;
+        }else if(p==BROOK||p==BQUEEN){
+            int c=0;
+            static const int D[4][2]={{1,0},{-1,0},{0,1},{0,-1}};
+            for(auto &d:D){
+                int nx=x+d[0], ny=y+d[1];
+                while(onBoard(nx,ny) && b[ny][nx]==EMPTY){ c++; nx+=d[0]; ny+=d[1]; }
+            }
+            mob -= E.v[EP_MOBILITY]*c;
+        }
+    }
+    score += mob;
+
+    return white_to_move ? score : -score;
+}
+
+// ============ Quiescência ============
+template<int Us>
+int DeepBeckyEngine::qsearchBody(int alpha, int beta, int ply){
+    typedef SideOf<Us> S;
+    pvt->len[ply] = ply;
+    STAT(q_nodes++);
+    if(ply>=MAX_PLY-1){ trace(TR_HORIZON); return evaluate(); }
+    if(men==3){
+        int sc;
+        if(probeKPK(sc)){ STAT(bitbase_hits++); trace(TR_BITBASE); return sc; }
+    }
+    int stand;
+    { STAT_PHASE(PH_EVAL); stand = evaluate(); }
+    if(stand >= beta){ trace(TR_STANDPAT); return beta; }
+    if(stand > alpha) alpha = stand;
+
+    vector<Move> legal;
+    {
+        STAT_PHASE(PH_MOVEGEN);
+        legal = genLegal<Us>(true); // somente capturas legais
+    }
+
+    // ordena por MVV-LVA
+    {
+        STAT_PHASE(PH_ORDER);
+        for(auto &m: legal){
+            int att=b[m.from_y][m.from_x];
+            int def = m.is_enpassant? SideOf<S::Them>::PAWN : b[m.to_y][m.to_x];
+            m.score = 10*PIECE_VALUE[def] - PIECE_VALUE[att];
+        }
+        stable_sort(legal.begin(), legal.end(), [](const Move&a,const Move&b){return a.score>b.score;});
+    }
+
+    int idx=0;
+    Move bestMove;
+    for(auto &m: legal){
+        idx++;
+        { STAT_PHASE(PH_MAKE); doMove<Us>(m); }
+        int sc = -qsearch(-beta, -alpha, ply+1);
+        { STAT_PHASE(PH_MAKE); undoMoveFor<Us>(m); }
+        if(sc >= beta){ trace(TR_BETA, m, idx, (int)legal.size()); return beta; }
+        if(sc > alpha){ alpha = sc; bestMove = m; updatePV(ply, m); }
+    }
+    trace(TR_NONE, bestMove, 0, (int)legal.size());
+    return alpha;
+}
+
+// ============ PVS com LMR + podas ============
+template<int Us>
+int DeepBeckyEngine::pvsBody(int depth, int ply, int alpha, int beta, bool allowNull){
+    typedef SideOf<Us> S;
+    pvt->len[ply] = ply;
+    if(stop || timeUp() || (node_limit && nodes>=node_limit)) { stop=true; trace(TR_STOP); return alpha; }
+    if(ply>0 && isDraw(ply)){ trace(TR_DRAW); return 0; }
+    if(ply>0 && men==3){
+        int sc;
+        if(probeKPK(sc)){ STAT(bitbase_hits++); trace(TR_BITBASE); return sc; }
+    }
+    if(depth<=0) return qsearch(alpha, beta, ply);
+    if(ply>=MAX_PLY-1){ trace(TR_HORIZON); return evaluate(); }
+
+    bool checked = kingAttacked<Us>();
+    if(checked){
+        depth++;
+        STAT(check_ext++);
+    }
+    bool pvNode = (beta - alpha > 1);
+
+    nodes++;
+    STAT(main_nodes++);
+
+    // TT probe
+    TTEntry &te = tt[hash & tt_mask];
+    Move ttMove{};
+    STAT(tt_probes++);
+    if(te.key==hash && te.depth>=depth){
+        STAT(tt_hits++);
+        int sc = te.score;
+        if(sc >= MATE_IN_MAX) sc -= ply; // mate guardado relativo ao nó
+        if(sc <= -MATE_IN_MAX) sc += ply;
+        if(te.flag==TT_EXACT){ STAT(tt_cutoffs++); trace(TR_TT, te.best); return sc; }
+        if(te.flag==TT_ALPHA && sc<=alpha){ STAT(tt_cutoffs++); trace(TR_TT, te.best); return alpha; }
+        if(te.flag==TT_BETA  && sc>=beta){ STAT(tt_cutoffs++); trace(TR_TT, te.best); return beta; }
+        ttMove = te.best;
+    }else if(te.key==hash){
+        STAT(tt_hits++);
+        ttMove = te.best;
+    }
+
+    // Mate distance pruning: nada pior que levar mate aqui, nada melhor que dar no próximo lance
+    int mate_alpha = -MATE_SCORE + ply;
+    int mate_beta  =  MATE_SCORE - ply - 1;
+    alpha = max(alpha, mate_alpha);
+    beta  = min(beta , mate_beta );
+    if(alpha>=beta){ trace(TR_MATE_DIST); return alpha; }
+
+    int staticEval = -INF_SCORE;
+    if(!checked && !pvNode){ STAT_PHASE(PH_EVAL); staticEval = evaluate(); }
+
+    // Reverse futility: avaliação estática folgada acima de beta perto das folhas
+    if(prune.rfp && !pvNode && !checked && depth<=RFP_MAX_DEPTH && abs(beta)<MATE_IN_MAX
+       && staticEval - RFP_MARGIN*depth >= beta){
+        stats.rfp_cuts++;
+        trace(TR_RFP);
+        return staticEval;
+    }
+
+    // Null move (R adaptativo). Em finais só de peões (zugzwang) o corte é
+    // confirmado por uma busca reduzida sem lance nulo.
+    if(prune.nmp && allowNull && !pvNode && !checked && depth>=NMP_MIN_DEPTH
+       && staticEval>=beta && abs(beta)<MATE_IN_MAX){
+        int R = 2 + depth/4;
+        stats.nmp_tries++;
+        move_pt[ply+2] = -1;
+        makeNullMove();
+        int sc = -pvs(depth-1-R, ply+1, -beta, -beta+1, false);
+        undoNullMove();
+        if(stop){ trace(TR_STOP); return alpha; }
+        if(sc>=beta){
+            if(sc>=MATE_IN_MAX) sc = beta;
+            if(hasNonPawnMaterial(Us==WHITE)){ stats.nmp_cuts++; trace(TR_NMP); return sc; }
+            int v = pvs(depth-R, ply, beta-1, beta, false);
+            if(v>=beta){ stats.nmp_cuts++; trace(TR_NMP); return sc; }
+            stats.nmp_verify_fail++;
+        }
+    }
+
+    // Geração e ordenação
+    vector<Move> mv;
+    { STAT_PHASE(PH_MOVEGEN); mv = genLegal<Us>(false); }
+    if(mv.empty()){
+        if(checked){ trace(TR_MATE); return -MATE_SCORE + ply; } // mate
+        trace(TR_STALEMATE);
+        return 0; // afogado
+    }
+    { STAT_PHASE(PH_ORDER); scoreMoves(mv, ttMove, ply); }
+
+    bool canPruneQuiets = !pvNode && !checked && abs(alpha)<MATE_IN_MAX;
+    bool futile = prune.fp && canPruneQuiets && depth<=FP_MAX_DEPTH
+                  && staticEval + FP_MARGIN[depth] <= alpha;
+    int lmpLimit = 3 + depth*depth;
+    int side = Us;
+    int prev1 = move_pt[ply+1], prev2 = move_pt[ply];
+    Move quietsTried[64]; int nQuiets=0;
+
+    int best=-INF_SCORE;
+    Move bestMove = mv[0];
+    int origAlpha = alpha;
+    int moveCount=0;
+    bool cut=false;
+
+    for(auto &m: mv){
+        moveCount++;
+        bool quiet = !m.is_capture && !m.promotion;
+        int from=sq(m.from_x,m.from_y), to=sq(m.to_x,m.to_y);
+        int pt = pieceTo(b[m.from_y][m.from_x], to);
+        int hist = heur->history[side][from][to];
+        if(prev1>=0) hist += heur->cont[0][prev1][pt];
+        if(prev2>=0) hist += heur->cont[1][prev2][pt];
+
+        // Late move pruning: lances quietos tardios perto das folhas
+        if(prune.lmp && canPruneQuiets && quiet && depth<=LMP_MAX_DEPTH && moveCount>lmpLimit){
+            stats.lmp_skips++;
+            continue;
+        }
+        move_pt[ply+2] = (int16_t)pt;
+        { STAT_PHASE(PH_MAKE); doMove<Us>(m); }
+        bool givesCheck = quiet && kingAttacked<S::Them>();
+        // Futility: quietos que não dão xeque não levantam alpha
+        if(futile && quiet && moveCount>1 && !givesCheck){
+            undoMoveFor<Us>(m);
+            stats.fp_skips++;
+            continue;
+        }
+        int sc;
+        if(moveCount==1){
+            sc = -pvs(depth-1, ply+1, -beta, -alpha);
+        }else{
+            // LMR pela tabela log, ajustada por PV/xeque/killer/history
+            int newDepth = depth-1;
+            int r = 0;
+            if(depth>=LMR_MIN_DEPTH && quiet && !m.is_castle){
+                r = LMR.R[min(depth, MAX_PLY-1)][min(moveCount, 63)];
+                if(pvNode) r--;
+                if(checked || givesCheck) r--;
+                if(m==heur->killers.killer[0][ply] || m==heur->killers.killer[1][ply]) r--;
+                r -= max(-2, min(2, hist / LMR_HIST_DIV));
+                r = max(0, min(r, newDepth-1));
+            }
+            if(r>0){
+                stats.lmr_reduced++;
+                sc = -pvs(newDepth-r, ply+1, -alpha-1, -alpha);
+                if(sc>alpha) stats.lmr_research++;
+            }else{
+                sc = alpha+1; // força pesquisa normal
+            }
+            if(sc>alpha){
+                sc = -pvs(newDepth, ply+1, -alpha-1, -alpha);
+                if(sc>alpha && sc<beta){
+                    stats.pvs_research++;
+                    sc = -pvs(newDepth, ply+1, -beta, -alpha);
+                }
+            }
+        }
+        { STAT_PHASE(PH_MAKE); undoMoveFor<Us>(m); }
+
+        if(sc>best){ best=sc; bestMove=m; }
+        if(sc>alpha){
+            alpha=sc;
+            updatePV(ply, m);
+            if(alpha>=beta){
+                stats.cutoffs++;
+                if(moveCount==1) stats.first_cutoffs++;
+                STAT(beta_cuts[min(moveCount, CUT_IDX_NB)-1]++);
+                // atualiza heurísticas (bônus no lance, malus nos quietos anteriores)
+                if(!m.is_capture) updateQuietStats(m, quietsTried, nQuiets, depth, ply);
+                cut=true;
+                break;
+            }
+        }
+        if(!m.is_capture && nQuiets<64) quietsTried[nQuiets++] = m;
+        if(stop) break;
+    }
+
+    // TT store
+    te.key = hash; te.depth=depth; te.best=bestMove;
+    int flag = TT_EXACT;
+    if(best<=origAlpha) flag = TT_ALPHA;
+    else if(best>=beta) flag = TT_BETA;
+    te.flag=flag;
+    int store = best;
+    if(best >= MATE_IN_MAX) store += ply;
+    if(best <= -MATE_IN_MAX) store -= ply;
+    te.score = (int16_t)store;
+
+    if(cut) trace(TR_BETA, bestMove, moveCount, (int)mv.size());
+    else    trace(stop? TR_STOP : TR_NONE, bestMove, 0, (int)mv.size());
+    return best;
+}
+
+// ============ Trace ============
+// Sem trace são só um desvio a mais por nó. Com trace, cada nó anota em
+// tr_note o motivo da saída e o wrapper grava o registro com o tamanho da
+// subárvore (ids consumidos pelos filhos).
+int DeepBeckyEngine::pvs(int depth, int ply, int alpha, int beta, bool allowNull){
+    if(!tracer || depth<=0) return white_to_move? pvsBody<WHITE>(depth, ply, alpha, beta, allowNull)
+                                                 : pvsBody<BLACK>(depth, ply, alpha, beta, allowNull);
+    uint32_t id = tracer->next_id++;
+    int r = white_to_move? pvsBody<WHITE>(depth, ply, alpha, beta, allowNull)
+                         : pvsBody<BLACK>(depth, ply, alpha, beta, allowNull);
+    TraceRecord tr{};
+    tr.hash = hash; tr.id = id; tr.subtree = tracer->next_id - id;
+    tr.alpha = (int16_t)alpha; tr.beta = (int16_t)beta; tr.result = (int16_t)r;
+    tr.move = tr_note.move; tr.ply = (uint8_t)ply; tr.depth = (int8_t)depth;
+    tr.kind = TK_PVS; tr.reason = tr_note.reason; tr.idx = tr_note.idx; tr.nmoves = tr_note.nmoves;
+    tracer->push(tr);
+    tr_note = TraceNote();
+    return r;
+}
+
+int DeepBeckyEngine::qsearch(int alpha, int beta, int ply){
+    if(!tracer) return white_to_move? qsearchBody<WHITE>(alpha, beta, ply) : qsearchBody<BLACK>(alpha, beta, ply);
+    uint32_t id = tracer->next_id++;
+    int r = white_to_move? qsearchBody<WHITE>(alpha, beta, ply) : qsearchBody<BLACK>(alpha, beta, ply);
+    TraceRecord tr{};
+    tr.hash = hash; tr.id = id; tr.subtree = tracer->next_id - id;
+    tr.alpha = (int16_t)alpha; tr.beta = (int16_t)beta; tr.result = (int16_t)r;
+    tr.move = tr_note.move; tr.ply = (uint8_t)ply; tr.depth = 0;
+    tr.kind = TK_QS; tr.reason = tr_note.reason; tr.idx = tr_note.idx; tr.nmoves = tr_note.nmoves;
+    tracer->push(tr);
+    tr_note = TraceNote();
+    return r;
+}
+
+bool SearchTracer::open(const string& path){
+    close();
+    out.open(path, ios::binary | ios::trunc);
+    if(!out) return false;
+    TraceHeader h{};
+    memcpy(h.magic, TRACE_MAGIC, sizeof(h.magic));
+    h.version = 1; h.record_size = sizeof(TraceRecord);
+    out.write((const char*)&h, sizeof(h));
+    head = 0; tail = 0; next_id = 0; done = false;
+    writer = thread([this]{ writerLoop(); });
+    return true;
+}
+
+void SearchTracer::close(){
+    if(writer.joinable()){
+        done.store(true, memory_order_release);
+        writer.join();
+    }
+    if(out.is_open()) out.close();
+}
+
+// Despeja o que a busca publicou; ao fechar, esvazia o ring antes de sair.
+void SearchTracer::writerLoop(){
+    for(;;){
+        size_t t = tail.load(memory_order_relaxed);
+        size_t h = head.load(memory_order_acquire);
+        if(t==h){
+            if(done.load(memory_order_acquire) && head.load(memory_order_acquire)==t) break;
+            this_thread::sleep_for(chrono::milliseconds(1));
+            continue;
+        }
+        while(t<h){
+            size_t i = t & (RING-1);
+            size_t n = min(h-t, RING-i);
+            out.write((const char*)&ring[i], n*sizeof(TraceRecord));
+            t += n;
+        }
+        tail.store(t, memory_order_release);
+    }
+    out.flush();
+}
+
+// ============ PV ============
+void DeepBeckyEngine::updatePV(int ply, const Move& m){
+    PVTable& t = *pvt;
+    t.m[ply][ply] = m;
+    int n = t.len[ply+1];
+    for(int j=ply+1; j<n; j++) t.m[ply][j] = t.m[ply+1][j];
+    t.len[ply] = max(n, ply+1);
+}
+
+string DeepBeckyEngine::scoreToUCI(int sc){
+    if(sc >= MATE_IN_MAX) return "mate " + to_string((MATE_SCORE - sc + 1)/2);
+    if(sc <= -MATE_IN_MAX) return "mate " + to_string(-(MATE_SCORE + sc)/2);
+    return "cp " + to_string(sc);
+}
+
+// ============ Raiz ============
+// PVS sobre root_moves[pvIdx..]: as linhas anteriores do MultiPV ficam de
+// fora. Cada lance guarda seu score e PV; quem não passa de alpha fica com
+// -INF_SCORE e a ordenação estável preserva a ordem anterior.
+int DeepBeckyEngine::searchRoot(int depth, int alpha, int beta, int pvIdx){
+    nodes++;
+    STAT(main_nodes++);
+    pvt->len[0] = 0;
+    bool checked = inCheck(white_to_move);
+    if(checked) depth++;
+    int best = -INF_SCORE;
+    int origAlpha = alpha, origBeta = beta;
+    uint32_t traceId = tracer? tracer->next_id++ : 0;
+    int side = white_to_move? 0:1;
+    Move quietsTried[64]; int nQuiets=0;
+    Move bestMove = root_moves[pvIdx].m;
+
+    for(size_t i=pvIdx; i<root_moves.size(); i++){
+        RootMove& rm = root_moves[i];
+        const Move& m = rm.m;
+        int moveCount = (int)i - pvIdx + 1;
+        bool quiet = !m.is_capture && !m.promotion;
+        move_pt[2] = pieceTo(b[m.from_y][m.from_x], sq(m.to_x,m.to_y));
+        makeMove(m);
+        int sc;
+        if(moveCount==1){
+            sc = -pvs(depth-1, 1, -beta, -alpha);
+        }else{
+            // LMR como num nó PV de pvs (a raiz é sempre PV)
+            int newDepth = depth-1, r = 0;
+            if(depth>=LMR_MIN_DEPTH && quiet && !m.is_castle){
+                int from=sq(m.from_x,m.from_y), to=sq(m.to_x,m.to_y);
+                r = LMR.R[min(depth, MAX_PLY-1)][min(moveCount, 63)] - 1;
+                if(checked || inCheck(white_to_move)) r--;
+                if(m==heur->killers.killer[0][0] || m==heur->killers.killer[1][0]) r--;
+                r -= max(-2, min(2, heur->history[side][from][to] / LMR_HIST_DIV));
+                r = max(0, min(r, newDepth-1));
+            }
+            if(r>0){
+                stats.lmr_reduced++;
+                sc = -pvs(newDepth-r, 1, -alpha-1, -alpha);
+                if(sc>alpha) stats.lmr_research++;
+            }else{
+                sc = alpha+1; // força pesquisa normal
+            }
+            if(sc>alpha){
+                sc = -pvs(newDepth, 1, -alpha-1, -alpha);
+                if(sc>alpha && sc<beta){
+                    stats.pvs_research++;
+                    sc = -pvs(newDepth, 1, -beta, -alpha);
+                }
+            }
+        }
+        undoMove(m);
+        if(stop) break;
+
+        if((int)i==pvIdx || sc>alpha){
+            rm.score = sc;
+            rm.pv.assign(1, m);
+            for(int j=1; j<pvt->len[1]; j++) rm.pv.push_back(pvt->m[1][j]);
+        }else{
+            rm.score = -INF_SCORE;
+        }
+        if(sc>best){ best=sc; bestMove=m; }
+        if(sc>alpha){
+            alpha=sc;
+            if(alpha>=beta){
+                stats.cutoffs++;
+                if(moveCount==1) stats.first_cutoffs++;
+                if(!m.is_capture) updateQuietStats(m, quietsTried, nQuiets, depth, 0);
+                break;
+            }
+        }
+        if(!m.is_capture && nQuiets<64) quietsTried[nQuiets++] = m;
+    }
+
+    // TT da raiz: só a linha principal, que viu todos os lances
+    if(pvIdx==0 && !stop && best>-INF_SCORE){
+        TTEntry& te = tt[hash & tt_mask];
+        te.key = hash; te.depth = (int8_t)depth; te.best = bestMove;
+        te.flag = best<=origAlpha? TT_ALPHA : best>=origBeta? TT_BETA : TT_EXACT;
+        te.score = (int16_t)best; // ply 0: nada a ajustar nos mates
+    }
+    if(tracer){
+        TraceRecord tr{};
+        tr.hash = hash; tr.id = traceId; tr.subtree = tracer->next_id - traceId;
+        tr.alpha = (int16_t)origAlpha; tr.beta = (int16_t)origBeta; tr.result = (int16_t)max(best, -INF_SCORE);
+        tr.move = packMove(root_moves[pvIdx].m); tr.depth = (int8_t)depth;
+        tr.kind = TK_ROOT; tr.idx = (uint8_t)min(pvIdx+1, 255); tr.nmoves = (uint8_t)min<size_t>(root_moves.size(), 255);
+        tr.reason = stop? TR_STOP : best<=origAlpha? TR_FAIL_LOW : best>=origBeta? TR_FAIL_HIGH : TR_NONE;
+        tracer->push(tr);
+        tr_note = TraceNote();
+    }
+    return best;
+}
+
+// ============ Busca (Iterative + Aspiration Windows + MultiPV) ============
+Move DeepBeckyEngine::search(int maxDepth, int timeMs, const vector<string>& searchMoves){
+    start_time = chrono::high_resolution_clock::now();
+    time_limit_ms = timeMs;
+    stop=false; nodes=0;
+    stats = SearchStats();
+    instr = InstrStats();
+    STAT(start_cycles = cycleCount());
+    heur->killers.clear();
+    move_pt[0] = move_pt[1] = -1;
+    root_moves.clear();
+    // book
+    vector<Move> root = generateLegal();
+    if(!searchMoves.empty()){
+        vector<Move> keep;
+        for(const auto& r: root)
+            if(find(searchMoves.begin(), searchMoves.end(), moveToUCI(r))!=searchMoves.end()) keep.push_back(r);
+        if(!keep.empty()) root.swap(keep);
+    }
+    if(root.empty()) return MOVE_NONE;
+
+    if(own_book && searchMoves.empty() && multi_pv==1){
+        Move bm;
+        if(probePolyglot(root, bm)) return bm;
+    }
+    if(own_book && !polyglot.isOpen() && uci_history.size()<12 && searchMoves.empty() && multi_pv==1){
+        auto it = opening_book.find(bookKey());
+        if(it!=opening_book.end()){
+            for(const auto& u: it->second){
+                for(const auto& r: root){
+                    if(moveToUCI(r)==u) return r;
+                }
+            }
+        }
+    }
+
+    // ordem inicial: TT + heurísticas
+    TTEntry &te = tt[hash & tt_mask];
+    scoreMoves(root, te.key==hash? te.best : MOVE_NONE, 0);
+    root_moves.clear();
+    for(const auto& r: root){ RootMove rm; rm.m=r; rm.pv.assign(1, r); root_moves.push_back(rm); }
+    int lines = min<int>(multi_pv, (int)root_moves.size());
+
+    for(int d=1; d<=maxDepth; ++d){
+        // Score só vale para a iteração: se o stop cortar esta, lances ainda
+        // não vistos ficam em -INF e a ordem da anterior decide o bestmove.
+        for(auto& rm: root_moves){ rm.prev_score = rm.score; rm.score = -INF_SCORE; }
+
+        for(int pvIdx=0; pvIdx<lines && !stop; ++pvIdx){
+            int prev = root_moves[pvIdx].prev_score;
+            int A = -INF_SCORE, B = INF_SCORE;
+            if(d>=3 && abs(prev)<MATE_IN_MAX){
+                int window = 35 + d*3;
+                A = prev - window;
+                B = prev + window;
+            }
+
+            int sc = searchRoot(d, A, B, pvIdx);
+
+            // re-search em falha
+            int expand=80;
+            while(!stop && (sc<=A || sc>=B)){
+                if(sc<=A) A = max(-INF_SCORE, A - expand);
+                else      B = min( INF_SCORE, B + expand);
+                stable_sort(root_moves.begin()+pvIdx, root_moves.end(),
+                            [](const RootMove& a, const RootMove& b){ return a.score>b.score; });
+                STAT(asp_researches++);
+                sc = searchRoot(d, A, B, pvIdx);
+                expand = int(expand*1.8)+10;
+            }
+            stable_sort(root_moves.begin()+pvIdx, root_moves.end(),
+                        [](const RootMove& a, const RootMove& b){ return a.score>b.score; });
+        }
+        if(stop && d>1) break;
+
+        auto now = chrono::high_resolution_clock::now();
+        long long ms = chrono::duration_cast<chrono::milliseconds>(now-start_time).count();
+
+        // Iteração 1 cortada: linhas sem score (-INF, no fim da ordem) não saem
+        for(int i=0; i<lines && root_moves[i].score>-INF_SCORE; i++){
+            const RootMove& rm = root_moves[i];
+            if(on_info){ on_info(d, i+1, rm, ms); continue; }
+            if(quiet_info) break;
+            lock_guard<mutex> lk(io_mx);
+            cout << infoLine(d, i+1, rm, ms) << endl;
+        }
+
+        if(ms > time_limit_ms) break;
+    }
+    STAT(total_cycles = cycleCount() - instr.start_cycles);
+    return root_moves[0].m;
+}
+
+// ============ Busca de mate ============
+// Atacante: todos os lances (xeques e capturas primeiro); no último lance só
+// xeques podem matar. Defensor: todas as respostas. Sem avaliação nem poda:
+// o resultado é exato para "mate em n" (ignora repetição e 50 lances).
+bool DeepBeckyEngine::mateAttack(int n){
+    nodes++;
+    if(stop || (node_limit && nodes>=node_limit) || timeUp()){ stop=true; return false; }
+    MateEntry& me = mate_tt[hash & mate_mask];
+    uint32_t key = (uint32_t)(hash>>32);
+    if(me.key==key){
+        if(me.proven && me.proven<=n) return true;
+        if(me.disproven>=n) return false;
+    }
+    vector<Move> moves = generateLegal();
+    uint16_t hint = me.key==key? me.move : 0;
+    vector<Move> replies;
+    if(n>1){
+        for(auto& m: moves){
+            makeMove(m);
+            bool check = inCheck(white_to_move);
+            undoMove(m);
+            m.score = (packMove(m)==hint? 1<<20 : 0) + (check? 1<<16 : 0)
+                    + (m.is_capture? 10*PIECE_VALUE[m.captured_piece] : 0) + (m.promotion? 800 : 0);
+        }
+        stable_sort(moves.begin(), moves.end(), [](const Move&a,const Move&b){return a.score>b.score;});
+    }
+    for(auto& m: moves){
+        makeMove(m);
+        bool check = inCheck(white_to_move), win = false;
+        if(check || n>1){
+            replies = generateLegal();
+            if(replies.empty()) win = check; // afogamento não serve
+            else if(n>1) win = mateDefend(n-1, replies);
+        }
+        undoMove(m);
+        if(stop) return false;
+        if(win){
+            MateEntry& e = mate_tt[hash & mate_mask];
+            if(e.key!=key) e = MateEntry();
+            e.key = key;
+            e.proven = (uint8_t)(e.proven? min(e.proven, (uint8_t)n) : n);
+            e.move = packMove(m);
+            return true;
+        }
+    }
+    MateEntry& e = mate_tt[hash & mate_mask];
+    if(e.key!=key) e = MateEntry();
+    e.key = key;
+    e.disproven = (uint8_t)max<int>(e.disproven, n);
+    return false;
+}
+
+// Todas as respostas precisam levar a mate em n; capturas primeiro (é
+// onde costuma estar a refutação).
+bool DeepBeckyEngine::mateDefend(int n, vector<Move>& replies){
+    for(auto& r: replies) r.score = r.is_capture? 10*PIECE_VALUE[r.captured_piece] : 0;
+    stable_sort(replies.begin(), replies.end(), [](const Move&a,const Move&b){return a.score>b.score;});
+    for(const auto& r: replies){
+        makeMove(r);
+        bool ok = mateAttack(n);
+        undoMove(r);
+        if(!ok) return false;
+    }
+    return true;
+}
+
+bool DeepBeckyEngine::mateSearch(int n, int timeMs){
+    start_time = chrono::high_resolution_clock::now();
+    time_limit_ms = timeMs;
+    stop=false; nodes=0;
+    root_moves.clear();
+    if(!mate_tt){
+        size_t entries = (size_t(MATE_HASH_MB)<<20) / sizeof(MateEntry);
+        mate_tt = make_unique<MateEntry[]>(entries);
+        mate_mask = entries-1;
+    }
+    n = max(1, min(n, 127));
+    int found = 0;
+    for(int k=1; k<=n && !stop; k++) if(mateAttack(k)){ found = k; break; }
+    if(!found) return false;
+
+    // Linha: lance da tabela para o atacante; o defensor resiste o máximo.
+    RootMove rm;
+    vector<Move> line;
+    for(int k=found; k>0; k--){
+        const MateEntry& me = mate_tt[hash & mate_mask];
+        Move am;
+        bool ok = false;
+        for(const auto& m: generateLegal()) if(packMove(m)==me.move){ am = m; ok = true; break; }
+        if(!ok || me.key!=(uint32_t)(hash>>32)) break;
+        makeMove(am); line.push_back(am);
+        vector<Move> replies = generateLegal();
+        if(replies.empty() || k==1) break;
+        int worst = 0; Move dm;
+        for(const auto& r: replies){
+            makeMove(r);
+            int j = 1;
+            while(j<k-1 && !mateAttack(j)) j++;
+            undoMove(r);
+            if(j>worst){ worst = j; dm = r; }
+        }
+        makeMove(dm); line.push_back(dm);
+        k = worst+1;
+    }
+    for(auto it=line.rbegin(); it!=line.rend(); ++it) undoMove(*it);
+    if(line.empty()) return false;
+
+    rm.m = line[0];
+    rm.pv = line;
+    rm.score = rm.prev_score = MATE_SCORE - (2*found-1);
+    root_moves.push_back(rm);
+    long long ms = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now()-start_time).count();
+    if(on_info) on_info(2*found-1, 1, rm, ms);
+    else if(!quiet_info){ lock_guard<mutex> lk(io_mx); cout << infoLine(2*found-1, 1, rm, ms) << endl; }
+    return true;
+}
+
+// Linha "info" de uma iteração (k = multipv, 1-based)
+string DeepBeckyEngine::infoLine(int depth, int k, const RootMove& rm, long long ms) const {
+    int sc = rm.score!=-INF_SCORE? rm.score : rm.prev_score;
+    ostringstream os;
+    os << "info depth " << depth;
+    if(multi_pv>1) os << " multipv " << k;
+    os << " score " << scoreToUCI(sc)
+       << " time " << ms << " nodes " << nodes
+       << " nps " << (ms>0? nodes*1000/ms : 0)
+       << " pv";
+    for(const auto& pm: rm.pv) os << ' ' << moveToUCI(pm);
+    return os.str();
+}
+
+// ============ Estatísticas da última busca ============
+// Comando "stats" (e fim de cada go quando compilado com DEEPBECKY_STATS).
+void DeepBeckyEngine::printStats() const {
+    auto pct=[](long long a, long long b){ return b>0? 100.0*a/b : 0.0; };
+    const SearchStats& s = stats;
+    cout << "info string stats nodes " << nodes << " cutoffs " << s.cutoffs
+         << " first " << fixed << setprecision(1) << pct(s.first_cutoffs, s.cutoffs) << "%"
+         << " lmr " << s.lmr_reduced << " re-search " << s.lmr_research
+         << " pvs re-search " << s.pvs_research
+         << " nmp " << s.nmp_cuts << "/" << s.nmp_tries << " rfp " << s.rfp_cuts
+         << " fp " << s.fp_skips << " lmp " << s.lmp_skips << endl;
+#ifdef DEEPBECKY_STATS
+    const InstrStats& t = instr;
+    long long all = t.main_nodes + t.q_nodes;
+    cout << "info string stats main " << t.main_nodes << " qsearch " << t.q_nodes
+         << " (" << pct(t.q_nodes, all) << "%)"
+         << " check-ext " << t.check_ext << " aspiration re-search " << t.asp_researches
+         << " bitbase " << t.bitbase_hits << endl;
+    cout << "info string stats tt probes " << t.tt_probes << " hits " << t.tt_hits
+         << " (" << pct(t.tt_hits, t.tt_probes) << "%) cutoffs " << t.tt_cutoffs
+         << " (" << pct(t.tt_cutoffs, t.tt_probes) << "%)" << endl;
+    long long cuts=0; for(long long c: t.beta_cuts) cuts += c;
+    cout << "info string stats beta-cut by move";
+    for(int i=0;i<CUT_IDX_NB;i++)
+        cout << ' ' << (i+1) << (i==CUT_IDX_NB-1? "+":"") << ":" << pct(t.beta_cuts[i], cuts) << "%";
+    cout << endl;
+    static const char* PH[PH_NB] = { "movegen", "order", "eval", "make/undo" };
+    cout << "info string stats cycles " << t.total_cycles/1000000 << "M";
+    for(int i=0;i<PH_NB;i++) cout << ' ' << PH[i] << ' ' << pct((long long)t.cycles[i], (long long)t.total_cycles) << "%";
+    cout << endl;
+#else
+    cout << "info string stats detailed counters disabled (build with -DDEEPBECKY_STATS)" << endl;
+#endif
+    cout.unsetf(ios::floatfield);
+    cout << setprecision(6);
+}
+
+// ============ Bench ============
+// Conjunto fixo de posições a profundidade fixa: total de nós é a assinatura
+// da busca. Depois repete com cada poda desligada para medir quantos nós
+// cada uma economiza.
+const char* const BENCH_FENS[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "r1bqkb1r/pppp1ppp/2n2n2/4p3/2B1P3/5N2/PPPP1PPP/RNBQK2R w KQkq - 4 4",
+    "r2q1rk1/pp2bppp/2n1pn2/3p4/2PP4/2N1PN2/PP3PPP/R2QKB1R w KQ - 0 9",
+    "2r2rk1/1bqnbppp/p2ppn2/1p6/3NP3/1BN1BP2/PPPQ2PP/2KR3R w - - 0 13",
+    "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+    "6k1/5ppp/8/8/8/8/5PPP/3R2K1 w - - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "8/8/4k3/3p4/3P4/4K3/8/8 w - - 0 1",
+    "8/5pk1/6p1/7p/7P/6P1/5PK1/8 w - - 0 1",
+    "4k3/8/8/8/8/8/4P3/4K3 w - - 0 1",
+    "r1b1k2r/ppppnppp/2n2q2/2b5/3NP3/2P1B3/PP3PPP/RN1QKB1R w KQkq - 0 1",
+};
+const int BENCH_FENS_NB = (int)(sizeof(BENCH_FENS)/sizeof(BENCH_FENS[0]));
+
+void DeepBeckyEngine::bench(int depth){
+    auto runSuite=[&](bool verbose, SearchStats& tot){
+        long long total=0;
+        tot = SearchStats();
+        for(const char* fen: BENCH_FENS){
+            clearTT(); clearHeuristics();
+            setFEN(fen);
+            search(depth, 24*60*60*1000);
+            total += nodes;
+            tot.add(stats);
+            if(verbose) cout << "info string bench " << fen << " nodes " << nodes << endl;
+        }
+        return total;
+    };
+
+    bool q=quiet_info; quiet_info=true;
+    PruneFlags saved=prune;
+    SearchStats tot;
+    auto t0 = chrono::high_resolution_clock::now();
+    long long base = runSuite(true, tot);
+    long long ms = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now()-t0).count();
+    cout << "info string null-move tries " << tot.nmp_tries << " cuts " << tot.nmp_cuts
+         << " verify-fail " << tot.nmp_verify_fail << endl;
+    cout << "info string rfp cuts " << tot.rfp_cuts << " futility skips " << tot.fp_skips
+         << " lmp skips " << tot.lmp_skips << endl;
+    cout << "info string lmr reduced " << tot.lmr_reduced << " re-searched " << tot.lmr_research
+         << " (" << (tot.lmr_reduced? 100.0*tot.lmr_research/tot.lmr_reduced : 0.0) << "%)"
+         << " pvs full-window re-searches " << tot.pvs_research << endl;
+    cout << "info string beta cutoffs " << tot.cutoffs << " on first move " << tot.first_cutoffs
+         << " (" << (tot.cutoffs? 100.0*tot.first_cutoffs/tot.cutoffs : 0.0) << "%)" << endl;
+
+    // ablação: nós a mais com cada poda desligada
+    const char* names[4] = {"null-move","reverse-futility","futility","late-move"};
+    bool* flags[4] = {&prune.nmp, &prune.rfp, &prune.fp, &prune.lmp};
+    for(int i=0;i<4;i++){
+        if(!*flags[i]) continue;
+        *flags[i]=false;
+        SearchStats dummy;
+        long long n = runSuite(false, dummy);
+        *flags[i]=true;
+        cout << "info string " << names[i] << " saves " << (n-base) << " nodes" << endl;
+    }
+    prune=saved; quiet_info=q;
+
+    cout << "Nodes searched  : " << base << endl;
+    cout << "Time (ms)       : " << ms << endl;
+    cout << "Nodes/second    : " << (ms>0? base*1000/ms : 0) << endl;
+    clearTT(); clearHeuristics(); setStartPos();
+}
+
+// ============ Posição / opções / go ============
+// Compartilhados pelo loop UCI e pela API embutível.
+
+// fen vazio ou "startpos" = posição inicial. Retorna quantos lances foram
+// aplicados (para no primeiro ilegal). Se a posição atual é a da chamada
+// anterior e a lista nova só acrescenta lances (o normal de uma GUI durante a
+// partida), aplica apenas os novos.
+size_t DeepBeckyEngine::setPosition(const string& fen, const vector<string>& moves){
+    string key = (fen.empty() || fen=="startpos")? string() : fen;
+    size_t from = 0;
+    if(key==pos_fen && hash==pos_hash && uci_history.size()==pos_moves.size()
+       && moves.size()>=pos_moves.size() && equal(pos_moves.begin(), pos_moves.end(), moves.begin())){
+        from = pos_moves.size();
+    }else{
+        if(key.empty()) setStartPos();
+        else setFEN(key);
+        pos_fen = key;
+        pos_moves.clear();
+    }
+    for(size_t i=from; i<moves.size(); i++){
+        Move lm;
+        if(!findLegal(uciToMove(moves[i]), lm)) break;
+        makeMove(lm);
+        pos_moves.push_back(moves[i]);
+    }
+    pos_hash = hash;
+    return pos_moves.size();
+}
+
+// name já em minúsculas. Retorna false se a opção não existe.
+bool DeepBeckyEngine::setOption(const string& name, const string& value){
+    if(name=="multipv"){
+        int n=1; stringstream(value)>>n;
+        multi_pv = max(1, min(MAX_MULTIPV, n));
+    }
+    else if(name=="hash"){
+        long long mb=DEFAULT_HASH_MB; stringstream(value)>>mb;
+        resizeTT((size_t)max(1LL, mb));
+    }
+    else if(name=="ownbook"){
+        own_book = (value=="true");
+    }
+    else if(name=="neverclearhash"){
+        keep_hash = (value=="true");
+    }
+    else if(name=="tracefile"){
+        trace_file = (value=="<empty>")? string() : value;
+        tracer.reset();
+        if(!trace_file.empty()){
+            tracer = make_unique<SearchTracer>();
+            if(tracer->open(trace_file)){ if(!quiet_info) cout << "info string tracing to " << trace_file << endl; }
+            else{
+                tracer.reset();
+                if(!quiet_info) cout << "info string could not open trace file " << trace_file << endl;
+            }
+        }
+    }
+    else if(name=="bookfile"){
+        book_file = (value=="<empty>")? string() : value;
+        polyglot.close();
+        if(!book_file.empty()){
+            if(polyglot.open(book_file)){ if(!quiet_info) cout << "info string book " << book_file << " opened" << endl; }
+            else if(!quiet_info) cout << "info string could not open book " << book_file << endl;
+        }
+    }
+    else return false;
+    return true;
+}
+
+// Limites do "go" -> profundidade, tempo e nós da busca
+Move DeepBeckyEngine::go(const SearchLimits& lim){
+    int search_time=0;
+    if(lim.infinite) search_time = 24*60*60*1000;
+    else if(lim.movetime!=-1) search_time = max(50, lim.movetime - 100);
+    else if(lim.wtime<0 && lim.btime<0 && (lim.depth>0 || lim.nodes>0 || lim.mate>0)) search_time = 24*60*60*1000;
+    else{
+        int tl = white_to_move? lim.wtime : lim.btime;
+        int inc= white_to_move? lim.winc  : lim.binc;
+        if(tl<=0) tl=60000;
+        search_time = (tl/30) + (inc*4/5);
+    }
+    int maxDepth = (lim.depth>0? min(lim.depth, MAX_PLY-1) : MAX_PLY);
+    node_limit = max(0LL, lim.nodes);
+    if(lim.mate>0){
+        if(mateSearch(lim.mate, search_time)){ node_limit = 0; return root_moves[0].m; }
+        if(!quiet_info && !on_info){ lock_guard<mutex> lk(io_mx); cout << "info string no mate in " << lim.mate << " found" << endl; }
+        // sem mate: lance de uma busca curta; se o solver foi cortado (stop,
+        // tempo ou nós), só o bastante para não devolver um lance qualquer
+        maxDepth = min(maxDepth, stop? 3 : 2*lim.mate);
+    }
+    Move bm = search(maxDepth, search_time, lim.searchmoves);
+    node_limit = 0;
+    return bm;
+}
+
+// ============ Parsing UCI ============
+void DeepBeckyEngine::printUciId(ostream& os){
+    os << "id name " << ENGINE_NAME << " " << ENGINE_VERSION << "\n"
+       << "id author " << ENGINE_AUTHOR << "\n"
+       << "option name Hash type spin default " << DEFAULT_HASH_MB << " min 1 max " << MAX_HASH_MB << "\n"
+       << "option name MultiPV type spin default 1 min 1 max " << MAX_MULTIPV << "\n"
+       << "option name NeverClearHash type check default false\n"
+       << "option name OwnBook type check default true\n"
+       << "option name BookFile type string default <empty>\n"
+       << "option name TraceFile type string default <empty>\n"
+       << "uciok" << endl;
+}
+
+// go [wtime ..] [btime ..] [winc ..] [binc ..] [movetime ..] [depth ..] [nodes ..] [mate ..] [infinite] [searchmoves ..]
+SearchLimits parseGo(istream& ss){
+    SearchLimits lim;
+    bool inSearchMoves=false;
+    string tok;
+    while(ss>>tok){
+        if(inSearchMoves && tok.size()>=4 && tok[0]>='a' && tok[0]<='h' && tok[1]>='1' && tok[1]<='8'){
+            lim.searchmoves.push_back(tok); continue;
+        }
+        inSearchMoves=false;
+        if(tok=="searchmoves") inSearchMoves=true;
+        else if(tok=="wtime") ss>>lim.wtime;
+        else if(tok=="btime") ss>>lim.btime;
+        else if(tok=="winc") ss>>lim.winc;
+        else if(tok=="binc") ss>>lim.binc;
+        else if(tok=="movetime") ss>>lim.movetime;
+        else if(tok=="depth") ss>>lim.depth;
+        else if(tok=="infinite") lim.infinite=true;
+        else if(tok=="movestogo") ss>>lim.movestogo;
+        else if(tok=="nodes") ss>>lim.nodes;
+        else if(tok=="mate") ss>>lim.mate;
+        // "ponder": busca normal, sem pondering
+    }
+    return lim;
+}
+
+// setoption name <id> [value <x>]
+void parseSetOption(istream& ss, string& name, string& value){
+    string tok; bool inValue=false;
+    name.clear(); value.clear();
+    ss>>tok; // "name"
+    while(ss>>tok){
+        if(!inValue && tok=="value"){ inValue=true; continue; }
+        string& dst = inValue? value : name;
+        if(!dst.empty()) dst+=' ';
+        dst+=tok;
+    }
+    for(auto& c: name) c=(char)tolower((unsigned char)c);
+}
+
+// position startpos|fen <6 campos> [moves ...]; fen vazio = posição inicial
+void parsePosition(istream& ss, string& fen, vector<string>& moves){
+    string t; ss>>t;
+    fen.clear(); moves.clear();
+    if(t=="fen"){
+        string token; int fields=0;
+        while(fields<6 && ss>>token){ fen += token + " "; fields++; }
+    }
+    string mstr;
+    while(ss>>mstr) if(mstr!="moves") moves.push_back(mstr);
+}
+
+// ============ UCI Loop ============
+// "go" roda numa thread de busca; enquanto ela vive o loop só atende stop,
+// isready e quit, e qualquer outro comando espera a busca terminar.
+void DeepBeckyEngine::run(){
+    ios::sync_with_stdio(false);
+    cin.tie(nullptr);
+
+    string line;
+    thread searcher;
+    atomic<bool> uciStop{false};
+    halt = &uciStop;
+    auto waitSearch = [&]{ if(searcher.joinable()) searcher.join(); };
+    setStartPos();
+    while (std::getline(cin, line)) {
+        if(line.empty()) continue;
+        stringstream ss(line);
+        string cmd; ss>>cmd;
+
+        if(cmd=="stop"){ uciStop=true; continue; }
+        if(cmd=="isready"){ lock_guard<mutex> lk(io_mx); cout << "readyok" << endl; continue; }
+        if(cmd=="quit"){ uciStop=true; break; }
+        waitSearch();
+
+        if(cmd=="uci"){
+            printUciId(cout);
+        }
+        else if(cmd=="setoption"){
+            string name, value;
+            parseSetOption(ss, name, value);
+            setOption(name, value);
+        }
+        else if(cmd=="ucinewgame"){
+            setStartPos();
+            if(!keep_hash) clearTT();
+            clearHeuristics();
+        }
+        else if(cmd=="position"){
+            string fen;
+            vector<string> moves;
+            parsePosition(ss, fen, moves);
+            size_t n = setPosition(fen, moves);
+            if(n<moves.size()) cout<<"info string illegal move from GUI: "<<moves[n]<<"\n";
+        }
+        else if(cmd=="go"){
+            SearchLimits lim = parseGo(ss);
+
+            vector<Move> root = generateLegal();
+            if(root.empty()){
+                if(inCheck(white_to_move)) cout<<"info string checkmate\n";
+                else cout<<"info string stalemate\n";
+                cout << "bestmove 0000" << endl;
+                continue;
+            }
+            uciStop=false;
+            searcher = thread([this, lim]{
+                Move bm = go(lim);
+                lock_guard<mutex> lk(io_mx);
+#ifdef DEEPBECKY_STATS
+                printStats();
+#endif
+                if( (bm.from_x|bm.from_y|bm.to_x|bm.to_y)==0 ){
+                    cout<<"bestmove 0000"<<endl;
+                }else{
+                    cout << "bestmove " << moveToUCI(bm) << endl;
+                }
+            });
+        }
+        else if(cmd=="savehash" || cmd=="loadhash"){
+            // savehash <arquivo> | loadhash <arquivo>
+            string path, err;
+            getline(ss>>ws, path);
+            if(path.empty()) cout << "info string usage: " << cmd << " <file>" << endl;
+            else if(cmd=="savehash" ? saveTT(path, err) : loadTT(path, err))
+                cout << "info string " << (cmd=="savehash"? "saved " : "loaded ") << (tt_mask+1) << " hash entries ("
+                     << hash_mb << " MB) " << (cmd=="savehash"? "to " : "from ") << path << endl;
+            else cout << "info string " << err << endl;
+        }
+        else if(cmd=="stats"){
+            printStats();
+        }
+        else if(cmd=="bench"){
+            int d=6; ss>>d;
+            bench(d);
+        }
+    }
+    waitSearch();
+    halt = nullptr;
+}
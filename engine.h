@@ -0,0 +1,721 @@
+/*
+ * Deep Becky 0.2 - UCI Chess Engine
+ * Copyright (C) 2025-2026 Diogo de Oliveira Almeida
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ */
+
+// Núcleo do engine: tipos, tabelas compartilhadas e a classe DeepBeckyEngine.
+// Uso interno (executável, API embutível e ferramentas); a interface pública
+// estável fica em deepbecky.h / deepbecky_c.h.
+#ifndef DEEPBECKY_ENGINE_H
+#define DEEPBECKY_ENGINE_H
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <array>
+#include <unordered_map>
+#include <chrono>
+#include <random>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <cmath>
+#include <memory>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <map>
+#include <atomic>
+#include <functional>
+#ifdef _MSC_VER
+  #include <intrin.h>
+#endif
+
+using namespace std;
+
+// ========================= Identidade =========================
+static const string ENGINE_NAME = "Deep Becky";
+static const string ENGINE_VERSION = "0.2";
+static const string ENGINE_AUTHOR = "Diogo de Oliveira Almeida";
+
+// ========================= Constantes globais =========================
+static const int INF_SCORE     = 30000;
+static const int MATE_SCORE    = 29000;
+static const int MATE_IN_MAX   = 28000;
+static const int MAX_PLY       = 64;
+static const int DEFAULT_HASH_MB = 192; // ~4M entradas
+static const int MAX_HASH_MB   = 65536;
+static const int MAX_MULTIPV   = 64;
+
+// ========================= Peças =========================
+enum Piece {
+    EMPTY=0,
+    WPAWN=1, WKNIGHT=2, WBISHOP=3, WROOK=4, WQUEEN=5, WKING=6,
+    BPAWN=7, BKNIGHT=8, BBISHOP=9, BROOK=10, BQUEEN=11, BKING=12
+};
+
+inline bool isWhitePiece(int p){ return p>=WPAWN && p<=WKING; }
+inline bool isBlackPiece(int p){ return p>=BPAWN && p<=BKING; }
+inline int  pieceColor(int p){ if(p==EMPTY) return -1; return isWhitePiece(p)?0:1; }
+
+// Cor como parâmetro de template: geração, make/undo e ataques são
+// instanciados por lado e as constantes abaixo saem em tempo de compilação.
+enum Color { WHITE=0, BLACK=1 };
+template<int Us> struct SideOf {
+    static constexpr int Them   = Us==WHITE? BLACK : WHITE;
+    static constexpr int PAWN   = Us==WHITE? WPAWN   : BPAWN;
+    static constexpr int KNIGHT = Us==WHITE? WKNIGHT : BKNIGHT;
+    static constexpr int BISHOP = Us==WHITE? WBISHOP : BBISHOP;
+    static constexpr int ROOK   = Us==WHITE? WROOK   : BROOK;
+    static constexpr int QUEEN  = Us==WHITE? WQUEEN  : BQUEEN;
+    static constexpr int KING   = Us==WHITE? WKING   : BKING;
+    static constexpr int FIRST  = PAWN, LAST = KING; // faixa das peças do lado
+    static constexpr int FWD      = Us==WHITE? 1 : -1;
+    static constexpr int HOME_Y   = Us==WHITE? 0 : 7;
+    static constexpr int START_Y  = Us==WHITE? 1 : 6;
+    static constexpr int PROMO_Y  = Us==WHITE? 6 : 1; // fileira antes de promover
+    static constexpr int EP_Y     = Us==WHITE? 4 : 3; // fileira de quem captura en passant
+    static constexpr int CASTLE_K = Us==WHITE? 0b1000 : 0b0010;
+    static constexpr int CASTLE_Q = Us==WHITE? 0b0100 : 0b0001;
+};
+
+// ========================= Movimentos =========================
+struct Move {
+    int from_x=0, from_y=0, to_x=0, to_y=0;
+    int promotion=0; // 0 sem promo; se !=0 usar Piece destino (WQUEEN, etc.)
+    bool is_capture=false, is_enpassant=false, is_castle=false, is_doublepush=false;
+    int captured_piece=EMPTY;
+    int score=0;
+    bool operator==(const Move& o) const {
+        return from_x==o.from_x && from_y==o.from_y && to_x==o.to_x && to_y==o.to_y &&
+               promotion==o.promotion && is_enpassant==o.is_enpassant && is_castle==o.is_castle;
+    }
+};
+static const Move MOVE_NONE;
+
+// ========================= Zobrist =========================
+struct Zobrist {
+    uint64_t piece[13][64]{};
+    uint64_t side=0, castling[16]{}, ep[9]{};
+    Zobrist(){
+        mt19937_64 rng(0xD10D10D10ULL ^ 0xC0FFEEBADBEEFULL);
+        for(int p=0;p<13;p++) for(int s=0;s<64;s++) piece[p][s]=rng();
+        side=rng();
+        for(int i=0;i<16;i++) castling[i]=rng();
+        for(int i=0;i<9;i++) ep[i]=rng();
+    }
+};
+extern Zobrist ZOB;
+
+// ========================= TT =========================
+enum TTFlag { TT_EXACT=0, TT_ALPHA=1, TT_BETA=2 };
+struct TTEntry {
+    uint64_t key;
+    int16_t  score;
+    int8_t   depth;
+    int8_t   flag;
+    Move     best;
+};
+
+// Arquivo da TT (savehash/loadhash): cabeçalho + entradas cruas. Versão,
+// tamanho da entrada e impressão das chaves Zobrist rejeitam arquivos de
+// outro build; o checksum cobre as entradas.
+struct TTFileHeader {
+    char     magic[8];   // "DBHASH\0\0"
+    uint32_t version;
+    uint32_t entry_size; // sizeof(TTEntry)
+    uint64_t entries;    // potência de 2
+    uint64_t zobrist;    // impressão de ZOB
+    uint64_t checksum;
+};
+static_assert(sizeof(TTFileHeader)==40, "TTFileHeader layout");
+static const uint32_t TT_FILE_VERSION = 1;
+
+// ========================= Heurísticas =========================
+// Tabelas de ordenação de lances quietos, uma por engine (por thread de busca).
+// Tudo em int16 com atualização "gravity" (satura em +-HIST_MAX) para caber
+// em ~600 KB e nunca estourar em partidas longas.
+static const int HIST_MAX = 16384;
+static const int PT_NB    = 6*64; // tipo de peça x casa destino (relativo ao lado)
+
+struct KillerTable {
+    Move killer[2][MAX_PLY];
+    void clear(){ memset(killer,0,sizeof(killer)); }
+};
+
+struct Heuristics {
+    KillerTable killers;
+    int16_t  history[2][64][64];     // side, from, to
+    uint16_t counter[2][PT_NB];      // side, lance anterior (peça-destino) -> from*64+to
+    int16_t  cont[2][PT_NB][PT_NB];  // [0]=1 ply atrás, [1]=2 plies atrás
+    void clear(){
+        killers.clear();
+        memset(history,0,sizeof(history));
+        memset(counter,0,sizeof(counter));
+        memset(cont,0,sizeof(cont));
+    }
+};
+
+inline int statBonus(int depth){ return min(32*depth*depth, 1536); }
+inline void gravity(int16_t& v, int bonus){ v = (int16_t)(v + bonus - v*abs(bonus)/HIST_MAX); }
+
+// ========================= LMR =========================
+// Redução base log(depth)*log(moveCount), pré-calculada na inicialização.
+struct LmrTable {
+    int8_t R[MAX_PLY][64]{};
+    LmrTable(){
+        for(int d=1; d<MAX_PLY; d++) for(int m=1; m<64; m++)
+            R[d][m] = (int8_t)(0.75 + log((double)d) * log((double)m) / 2.25);
+    }
+};
+extern LmrTable LMR;
+
+// ========================= Bitbase KPK =========================
+// Rei e peão contra rei, resolvido por análise retrógrada na inicialização:
+// 2 (vez) x 24 (peão nas colunas a-d, fileiras 2-7) x 64 x 64 posições, um
+// bit (vitória do lado do peão) cada = 24 KB.
+struct KPKBitbase {
+    uint64_t win[2*24*64*64/64]{};
+    KPKBitbase();
+    // Lado forte = brancas (peão subindo); casas 0..63 = a1..h8.
+    bool probe(bool strongToMove, int strongKing, int pawn, int weakKing) const;
+};
+extern KPKBitbase KPK;
+static const int KPK_WIN_SCORE = 600; // abaixo de uma dama, para a busca preferir promover
+
+// ========================= Utilidades =========================
+inline int sq(int x,int y){ return y*8 + x; }
+inline bool onBoard(int x,int y){ return x>=0 && x<8 && y>=0 && y<8; }
+inline int sgn(int v){ return (v>0)-(v<0); }
+// peça-destino relativo ao lado (pretas espelhadas): índice das tabelas de continuação
+inline int pieceTo(int piece, int toSq){
+    return isWhitePiece(piece)? (piece-WPAWN)*64 + toSq : (piece-BPAWN)*64 + (toSq^56);
+}
+// ========================= Parâmetros da avaliação =========================
+// Todos os pesos de evaluate() num vetor só (ajustado por "deepbecky tune").
+// Layout: material P N B R Q | PST P N B R Q K-MG K-EG (64 casas cada, lado
+// branco) | par de bispos | mobilidade de torre/dama por casa.
+enum EvalPst { PST_P, PST_N, PST_B, PST_R, PST_Q, PST_KMG, PST_KEG, PST_NB };
+enum EvalParam {
+    EP_MATERIAL    = 0,
+    EP_PST         = EP_MATERIAL + 5,
+    EP_BISHOP_PAIR = EP_PST + PST_NB*64,
+    EP_MOBILITY,
+    EP_NB
+};
+
+struct EvalParams {
+    int v[EP_NB]{};
+    int material(int type) const { return v[EP_MATERIAL+type]; } // 0..4 = P..Q
+    int pst(int table, int sqi) const { return v[EP_PST+table*64+sqi]; }
+};
+extern const EvalParams EVAL_DEFAULT; // eval_params.h
+// Lê um arquivo no formato de eval_params.h (ex.: saída do tune).
+bool loadEvalParams(const string& path, EvalParams& out);
+
+// ========================= Instrumentação =========================
+// Contadores detalhados da busca, compilados só com -DDEEPBECKY_STATS. Sem a
+// flag as macros somem e a busca gera o mesmo código de antes.
+enum StatPhase { PH_MOVEGEN, PH_ORDER, PH_EVAL, PH_MAKE, PH_NB };
+static const int CUT_IDX_NB = 8; // cortes beta pelo índice do lance; o último junta 8+
+
+struct InstrStats {
+    long long main_nodes=0, q_nodes=0;
+    long long tt_probes=0, tt_hits=0, tt_cutoffs=0;
+    long long beta_cuts[CUT_IDX_NB]={};
+    long long asp_researches=0, check_ext=0, bitbase_hits=0;
+    uint64_t  cycles[PH_NB]={};  // por fase (inclusivo: geração legal inclui make/undo)
+    uint64_t  start_cycles=0, total_cycles=0;
+};
+
+inline uint64_t cycleCount(){
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+    return __builtin_ia32_rdtsc();
+#else
+    return (uint64_t)chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+#ifdef DEEPBECKY_STATS
+struct PhaseTimer {
+    uint64_t& acc; uint64_t t0;
+    explicit PhaseTimer(uint64_t& a) : acc(a), t0(cycleCount()) {}
+    ~PhaseTimer(){ acc += cycleCount()-t0; }
+};
+  #define STAT(x)        do{ instr.x; }while(0)
+  #define STAT_PHASE(ph) PhaseTimer phase_timer_(instr.cycles[ph])
+#else
+  #define STAT(x)        do{}while(0)
+  #define STAT_PHASE(ph) do{}while(0)
+#endif
+
+// ========================= Livro Polyglot =========================
+// Arquivo somente leitura mapeado em memória: abrir é instantâneo e as
+// páginas só entram na memória residente quando são tocadas.
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile(){ close(); }
+
+    bool open(const string& path);
+    void close();
+
+    const uint8_t* data() const { return ptr; }
+    size_t size() const { return len; }
+
+private:
+    const uint8_t* ptr=nullptr;
+    size_t len=0;
+    void* file=nullptr;    // HANDLEs no Windows; sem uso em POSIX
+    void* mapping=nullptr;
+};
+
+// Entradas de 16 bytes big-endian ordenadas por chave, consultadas direto no
+// arquivo mapeado. As chaves Zobrist são uniformes, então a busca por
+// interpolação acha a posição em ~log log n leituras (2-3 num livro de
+// milhões de entradas); depois de 8 palpites cai na busca binária.
+struct PolyglotEntry {
+    uint64_t key;
+    uint16_t move, weight;
+    uint32_t learn;
+};
+
+class PolyglotBook {
+public:
+    bool open(const string& path){
+        count=0;
+        if(!mf.open(path)) return false;
+        count = mf.size()/16;
+        if(!count){ mf.close(); return false; }
+        return true;
+    }
+    void close(){ mf.close(); count=0; }
+    bool isOpen() const { return count>0; }
+
+    // Todas as entradas com a chave dada (contíguas no arquivo)
+    void probe(uint64_t key, vector<PolyglotEntry>& out) const {
+        out.clear();
+        // Primeira entrada com chave >= key: fica sempre em [lo, hi]
+        size_t lo=0, hi=count;
+        for(int guess=0; guess<8 && hi-lo>8; guess++){
+            uint64_t klo = entry(lo).key, khi = entry(hi-1).key;
+            if(klo>=key){ hi=lo; break; }
+            if(khi<key){ lo=hi; break; }
+            size_t mid = lo + (size_t)((long double)(key-klo) / (long double)(khi-klo) * (long double)(hi-1-lo));
+            mid = min(mid, hi-1);
+            if(entry(mid).key < key) lo=mid+1; else hi=mid;
+        }
+        while(lo<hi){
+            size_t mid = lo + (hi-lo)/2;
+            if(entry(mid).key < key) lo=mid+1; else hi=mid;
+        }
+        for(size_t i=lo; i<count; i++){
+            PolyglotEntry e = entry(i);
+            if(e.key!=key) break;
+            out.push_back(e);
+        }
+    }
+
+private:
+    MappedFile mf;
+    size_t count=0;
+
+    static uint64_t be(const uint8_t* p, int n){
+        uint64_t v=0;
+        for(int i=0;i<n;i++) v = (v<<8) | p[i];
+        return v;
+    }
+    PolyglotEntry entry(size_t i) const {
+        const uint8_t* p = mf.data() + i*16;
+        PolyglotEntry e;
+        e.key    = be(p, 8);
+        e.move   = (uint16_t)be(p+8, 2);
+        e.weight = (uint16_t)be(p+10, 2);
+        e.learn  = (uint32_t)be(p+12, 4);
+        return e;
+    }
+};
+
+// ========================= Trace =========================
+// Um registro de 32 bytes por nó de pvs/qsearch (mais um por chamada de
+// searchRoot), gravado na saída do nó. Ids seguem a ordem de entrada, então a
+// subárvore de um nó são os ids [id, id+subtree). Arquivo: TraceHeader e
+// depois os registros, little-endian; tools/tracestat.cpp resume.
+enum TraceKind   { TK_PVS=0, TK_QS=1, TK_ROOT=2 };
+enum TraceReason {
+    TR_NONE=0,      // todos os lances buscados (exato ou fail-low)
+    TR_BETA,        // corte beta por um lance (idx = índice do lance, 1-based)
+    TR_TT, TR_RFP, TR_NMP, TR_MATE_DIST,
+    TR_STANDPAT, TR_DRAW, TR_MATE, TR_STALEMATE, TR_HORIZON, TR_STOP,
+    TR_FAIL_LOW, TR_FAIL_HIGH, // raiz: janela de aspiração estourou
+    TR_BITBASE,     // final resolvido pela bitbase KPK
+    TR_NB
+};
+static const char TRACE_MAGIC[8] = { 'D','B','T','R','A','C','E','\0' };
+
+struct TraceHeader {
+    char magic[8];
+    uint32_t version, record_size;
+};
+
+struct TraceRecord {
+    uint64_t hash;
+    uint32_t id, subtree;   // subtree inclui o próprio nó
+    int16_t  alpha, beta, result;
+    uint16_t move;          // melhor lance / lance do corte (packMove)
+    uint8_t  ply; int8_t depth;
+    uint8_t  kind, reason;
+    uint8_t  idx, nmoves;   // índice do lance do corte / lances gerados
+    uint8_t  pad[2];
+};
+static_assert(sizeof(TraceRecord)==32, "TraceRecord deve ter 32 bytes");
+
+// from | to<<6 | promo<<12 (1=N 2=B 3=R 4=Q)
+inline uint16_t packMove(const Move& m){
+    int promo = m.promotion? (m.promotion-1)%6 : 0;
+    return (uint16_t)(sq(m.from_x,m.from_y) | sq(m.to_x,m.to_y)<<6 | promo<<12);
+}
+inline string packedToUCI(uint16_t pm){
+    if(!pm) return "0000";
+    string s;
+    s += char('a'+(pm&7)); s += char('1'+((pm>>3)&7));
+    s += char('a'+((pm>>6)&7)); s += char('1'+((pm>>9)&7));
+    if(pm>>12) s += "?nbrq"[(pm>>12)&7];
+    return s;
+}
+
+// Ring buffer SPSC por engine: a busca só escreve na memória e uma thread
+// própria despeja no arquivo. Ring cheio = a busca espera (nada se perde).
+class SearchTracer {
+public:
+    static const size_t RING = 1<<16;
+    SearchTracer() : ring(RING) {}
+    SearchTracer(const SearchTracer&) = delete;
+    SearchTracer& operator=(const SearchTracer&) = delete;
+    ~SearchTracer(){ close(); }
+
+    bool open(const string& path);
+    void close();
+    void push(const TraceRecord& r){
+        size_t h = head.load(memory_order_relaxed);
+        while(h - tail.load(memory_order_acquire) >= RING) this_thread::yield();
+        ring[h & (RING-1)] = r;
+        head.store(h+1, memory_order_release);
+    }
+    uint32_t next_id = 0;
+
+private:
+    void writerLoop();
+    vector<TraceRecord> ring;
+    alignas(64) atomic<size_t> head{0};
+    alignas(64) atomic<size_t> tail{0};
+    atomic<bool> done{false};
+    ofstream out;
+    thread writer;
+};
+
+// ========================= Posições empacotadas =========================
+// 32 bytes por posição (gensfen/tune): ocupação + um nibble por peça em ordem
+// de casa, score da busca, melhor lance e resultado. O arquivo é só a
+// sequência de registros, então arquivos podem ser concatenados.
+struct PackedPos {
+    uint64_t occupied;   // bit = casa (a1=0)
+    uint8_t  pieces[16]; // Piece (1..12) em nibbles, nibble baixo primeiro
+    int16_t  score;      // cp do lado a jogar
+    uint16_t move;       // packMove
+    uint8_t  flags;      // bit0 = pretas jogam, bits1-4 = roques KQkq
+    uint8_t  ep;         // coluna en passant + 1 (0 = nenhuma)
+    uint8_t  halfmove;
+    int8_t   result;     // lado a jogar: 1 vitória, 0 empate, -1 derrota
+};
+static_assert(sizeof(PackedPos)==32, "PackedPos deve ter 32 bytes");
+
+class SfenWriter {
+public:
+    bool open(const string& path, bool append=false);
+    void write(const PackedPos* p, size_t n); // thread-safe
+    void close();
+    long long count() const { return written; }
+private:
+    mutex mx;
+    ofstream out;
+    atomic<long long> written{0};
+};
+
+class SfenReader {
+public:
+    bool open(const string& path);
+    bool next(PackedPos& p);
+private:
+    ifstream in;
+    vector<PackedPos> buf;
+    size_t pos=0, len=0;
+};
+
+// Posições fixas do bench (também usadas pelo microbench)
+extern const char* const BENCH_FENS[];
+extern const int BENCH_FENS_NB;
+
+// ========================= Limites de busca =========================
+// O que vem no "go" (ou na API): go() converte em profundidade/tempo/nós.
+// ========================= Busca de mate =========================
+// Tabela própria do "go mate": 8 bytes por posição, com o menor N provado
+// (mate em N) e o maior N refutado. O resultado não depende do histórico,
+// então a tabela sobrevive entre buscas.
+struct MateEntry {
+    uint32_t key=0;
+    uint8_t  proven=0, disproven=0; // 0 = nada sabido
+    uint16_t move=0;                // packMove do lance que mata
+};
+static const int MATE_HASH_MB = 16;
+
+struct SearchLimits {
+    int depth=0;                 // 0 = sem limite
+    int mate=0;                  // "go mate N": só busca mate em até N lances
+    int movetime=-1;             // ms
+    long long nodes=0;           // 0 = sem limite
+    int wtime=-1, btime=-1, winc=0, binc=0, movestogo=0;
+    bool infinite=false;
+    vector<string> searchmoves;
+};
+
+// Argumentos dos comandos UCI (run() e o servidor)
+SearchLimits parseGo(istream& ss);
+void parseSetOption(istream& ss, string& name, string& value); // name em minúsculas
+void parsePosition(istream& ss, string& fen, vector<string>& moves);
+
+// ========================= Engine principal =========================
+// Todo o estado de busca (TT, killers, history, PV) pertence à instância:
+// engines diferentes podem buscar em paralelo, cada uma na sua thread.
+class DeepBeckyEngine {
+public:
+    // Tabuleiro 8x8
+    int b[8][8]{};
+    bool white_to_move=true;
+    int castling=0b1111; // KQkq
+    int ep_file=0;       // 1..8 se existe EP
+    int halfmove=0, fullmove=1;
+    int men=0;           // peças no tabuleiro, reis incluídos
+
+    // Hash
+    uint64_t hash=0;
+
+    // Search
+    long long nodes=0;
+    long long node_limit=0;  // 0 = sem limite ("go nodes")
+    atomic<bool> stop{false}; // pode ser ligado de outra thread
+    atomic<bool>* halt=nullptr; // stop externo: search() zera "stop", nunca este
+    chrono::high_resolution_clock::time_point start_time;
+    int time_limit_ms=0;
+
+    // Histórico para repetição / book simples
+    vector<string> uci_history;
+    vector<uint64_t> hash_history; // hashes das posições anteriores (jogo + caminho da busca)
+    unordered_map<string, vector<string>> opening_book;
+
+    // Última "position" aplicada: se a próxima só estende a lista, aplica o resto
+    string pos_fen;
+    vector<string> pos_moves;
+    uint64_t pos_hash=0;
+
+    // Livro Polyglot externo (opção BookFile); sem arquivo vale o book embutido
+    PolyglotBook polyglot;
+    string book_file;
+    mt19937_64 book_rng{(uint64_t)chrono::high_resolution_clock::now().time_since_epoch().count()};
+
+    // Stack p/ desfazer
+    struct Undo {
+        int captured, castling_before, ep_before, half_before, full_before;
+        bool side_before;
+        uint64_t hash_before;
+    };
+    vector<Undo> undo;
+
+    // Contadores de poda (por busca) e chaves p/ medir cada técnica no bench
+    struct SearchStats {
+        long long nmp_tries=0, nmp_cuts=0, nmp_verify_fail=0;
+        long long rfp_cuts=0, fp_skips=0, lmp_skips=0;
+        long long lmr_reduced=0, lmr_research=0, pvs_research=0;
+        long long cutoffs=0, first_cutoffs=0;
+        void add(const SearchStats& o){
+            nmp_tries+=o.nmp_tries; nmp_cuts+=o.nmp_cuts; nmp_verify_fail+=o.nmp_verify_fail;
+            rfp_cuts+=o.rfp_cuts; fp_skips+=o.fp_skips; lmp_skips+=o.lmp_skips;
+            lmr_reduced+=o.lmr_reduced; lmr_research+=o.lmr_research; pvs_research+=o.pvs_research;
+            cutoffs+=o.cutoffs; first_cutoffs+=o.first_cutoffs;
+        }
+    } stats;
+    InstrStats instr; // só é preenchido com DEEPBECKY_STATS
+
+    // Trace (opção TraceFile): cada saída de nó anota motivo/lance em tr_note
+    unique_ptr<SearchTracer> tracer;
+    string trace_file;
+    struct TraceNote { uint8_t reason=TR_NONE, idx=0, nmoves=0; uint16_t move=0; } tr_note;
+    void trace(int reason, const Move& m=MOVE_NONE, int idx=0, int n=0){
+        if(tracer) tr_note = { (uint8_t)reason, (uint8_t)min(idx,255), (uint8_t)min(n,255), packMove(m) };
+    }
+    struct PruneFlags {
+        bool nmp=true, rfp=true, fp=true, lmp=true;
+    } prune;
+    bool quiet_info=false; // silencia "info" (bench)
+    mutex io_mx;           // stdout dividido entre o loop UCI e a thread de busca
+
+    // Ordenação: tabelas por engine + peça-destino dos lances do caminho atual
+    unique_ptr<Heuristics> heur = make_unique<Heuristics>();
+    int move_pt[MAX_PLY+2]; // move_pt[ply+2] = lance feito no ply (-1 = nulo/nenhum)
+
+    // PV triangular: pv[ply][ply..len[ply]) é a variante principal a partir do ply
+    struct PVTable {
+        Move m[MAX_PLY][MAX_PLY];
+        int  len[MAX_PLY];
+    };
+    unique_ptr<PVTable> pvt = make_unique<PVTable>();
+
+    // Lances de raiz, reordenados pelo score da iteração anterior
+    struct RootMove {
+        Move m;
+        int score=-INF_SCORE, prev_score=-INF_SCORE;
+        vector<Move> pv;
+    };
+    vector<RootMove> root_moves;
+    int multi_pv=1;
+
+    // Saída de cada iteração (depth, multipv 1-based, linha, ms). Sem callback
+    // vai para stdout no formato UCI.
+    function<void(int, int, const RootMove&, long long)> on_info;
+
+    // TT própria, potência de 2 entradas dentro de hash_mb
+    unique_ptr<TTEntry[]> tt_mem;
+    TTEntry* tt = nullptr;
+    size_t   tt_mask = 0;
+    size_t   hash_mb = 0;
+    bool keep_hash = false; // NeverClearHash: ucinewgame não limpa a TT
+    bool own_book = true;
+
+    explicit DeepBeckyEngine(size_t hashMB = DEFAULT_HASH_MB){
+        initBook();
+        resizeTT(hashMB);
+        clearHeuristics();
+        setStartPos();
+    }
+
+    // ===== Interface UCI =====
+    void run();
+    static void printUciId(ostream& os); // resposta ao "uci": id, opções, uciok
+    string infoLine(int depth, int k, const RootMove& rm, long long ms) const;
+    void bench(int depth);
+    void printStats() const;
+    void setStartPos();
+    void setFEN(const string &fen);
+    string getFEN() const;
+    PackedPos pack(int score, const Move& m, int result) const;
+    void unpack(const PackedPos& p);
+    size_t setPosition(const string& fen, const vector<string>& moves);
+    bool setOption(const string& name, const string& value);
+    Move go(const SearchLimits& lim);
+
+    // ===== Movimentos =====
+    vector<Move> generateLegal(bool capturesOnly=false);
+    vector<Move> generatePseudo(bool capturesOnly=false);
+    bool isAttacked(int x,int y,bool byWhite);
+    bool inCheck(bool whiteSide);
+    // Versões por cor; as de cima só despacham em white_to_move/byWhite.
+    template<int Us> void genPseudo(vector<Move>& mv, bool capturesOnly);
+    template<int Us> vector<Move> genLegal(bool capturesOnly);
+    template<int Us> bool attackedBy(int x, int y) const;
+    template<int Us> bool kingAttacked() const;
+    template<int Us> bool legalFor(const Move& m);
+    template<int Us> void doMove(const Move& m);
+    template<int Us> void undoMoveFor(const Move& m);
+    void makeMove(const Move& m);
+    void undoMove(const Move& m);
+    void makeNullMove();
+    void undoNullMove();
+    bool hasNonPawnMaterial(bool whiteSide) const;
+    bool legalMove(const Move& m);
+
+    // ===== Busca =====
+    Move search(int maxDepth, int timeMs, const vector<string>& searchMoves = {});
+    int  searchRoot(int depth, int alpha, int beta, int pvIdx);
+    void updatePV(int ply, const Move& m);
+    int  pvs(int depth, int ply, int alpha, int beta, bool allowNull=true);
+    int  qsearch(int alpha, int beta, int ply);
+    // Corpo do nó com a cor fixa: a vez é despachada uma vez por nó, em pvs/qsearch
+    template<int Us> int pvsBody(int depth, int ply, int alpha, int beta, bool allowNull);
+    template<int Us> int qsearchBody(int alpha, int beta, int ply);
+    // Mate em até n lances (ID em n); acha a linha em root_moves[0].
+    bool mateSearch(int n, int timeMs);
+    bool mateAttack(int n);
+    bool mateDefend(int n, vector<Move>& replies);
+    unique_ptr<MateEntry[]> mate_tt;
+    size_t mate_mask = 0;
+
+    // ===== Ordenação =====
+    void scoreMoves(vector<Move>& mv, const Move& ttMove, int ply);
+    void updateQuietStats(const Move& best, const Move* quiets, int nQuiets, int depth, int ply);
+
+    // ===== Avaliação =====
+    const EvalParams* eval = &EVAL_DEFAULT;
+    int evaluate();
+    bool probeKPK(int& score) const; // só com men==3
+
+    // ===== Auxiliares =====
+    string moveToUCI(const Move& m) const;
+    static string scoreToUCI(int sc);
+    Move   uciToMove(const string& s) const;
+    bool   findLegal(const Move& want, Move& out);
+    uint64_t computeHash() const;
+    uint64_t polyglotKey() const;
+    bool probePolyglot(const vector<Move>& root, Move& out);
+    bool isDraw(int ply);
+    bool insufficientMaterial() const;
+    void resizeTT(size_t mb);
+    void rehashTT(size_t mb); // como resizeTT, mas leva as entradas para a nova tabela
+    bool saveTT(const string& path, string& err) const;
+    bool loadTT(const string& path, string& err);
+    void clearTT(){ for(size_t i=0;i<=tt_mask;i++) tt[i]=TTEntry(); }
+    void clearHeuristics(){ heur->clear(); }
+    string bookKey() const {
+        string s; int limit=min<int>(12, uci_history.size());
+        for(int i=(int)uci_history.size()-limit; i<(int)uci_history.size(); ++i) if(i>=0){
+            s+=uci_history[i]; s+=' ';
+        }
+        return s;
+    }
+    bool timeUp() const {
+        if(halt && *halt) return true;
+        auto now = chrono::high_resolution_clock::now();
+        return chrono::duration_cast<chrono::milliseconds>(now - start_time).count() > time_limit_ms;
+    }
+    void initBook(){
+        opening_book.clear();
+        opening_book["e2e4 e7e5 "] = {"g1f3","d2d4"};
+        opening_book["d2d4 d7d5 "] = {"c1f4","g1f3"};
+    }
+};
+
+// ========================= Ferramentas =========================
+int runTune(int argc, char** argv);    // tune.cpp
+int runGensfen(int argc, char** argv); // gensfen.cpp
+int runMatch(int argc, char** argv);   // match.cpp
+int runMakebook(int argc, char** argv); // book.cpp
+int runServer(int argc, char** argv);   // server.cpp
+int runConnect(int argc, char** argv);  // server.cpp
+
+#endif // DEEPBECKY_ENGINE_H
@@ -0,0 +1,101 @@
+/*
+ * Deep Becky 0.2 - UCI Chess Engine
+ * Copyright (C) 2025-2026 Diogo de Oliveira Almeida
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ */
+
+// Pesos da avaliação em centipeões, lidos por evaluate() via EvalParams.
+// Gerado por "deepbecky tune" (--out) e pode ser substituído pela saída dele.
+// PSTs do ponto de vista das brancas, a1..h8 (primeira linha = fileira 1);
+// as pretas usam a casa espelhada.
+#ifndef DEEPBECKY_EVAL_PARAMS_H
+#define DEEPBECKY_EVAL_PARAMS_H
+
+static const int EVAL_MATERIAL[5] = { 100, 320, 330, 500, 900 }; // P N B R Q
+
+static const int EVAL_PST[7][64] = {
+    { // peão
+           0,   5,   5,  -5,  -5,   5,   5,   0,
+           0,  10,  -5,   0,   0,  -5,  10,   0,
+           0,  10,  10,  20,  20,  10,  10,   0,
+           5,  15,  20,  25,  25,  20,  15,   5,
+          10,  20,  25,  30,  30,  25,  20,  10,
+          15,  25,  30,  35,  35,  30,  25,  15,
+          30,  40,  45,  50,  50,  45,  40,  30,
+           0,   0,   0,   0,   0,   0,   0,   0,
+    },
+    { // cavalo
+         -30, -10, -10, -10, -10, -10, -10, -30,
+         -10,   0,   5,   0,   0,   5,   0, -10,
+         -10,   5,  10,  10,  10,  10,   5, -10,
+         -10,   0,  10,  15,  15,  10,   0, -10,
+         -10,   0,  10,  15,  15,  10,   0, -10,
+         -10,   5,  10,  10,  10,  10,   5, -10,
+         -10,   0,   5,   0,   0,   5,   0, -10,
+         -30, -10, -10, -10, -10, -10, -10, -30,
+    },
+    { // bispo
+         -20, -10, -10, -10, -10, -10, -10, -20,
+         -10,  10,   0,   5,   5,   0,  10, -10,
+         -10,   5,  10,  10,  10,  10,   5, -10,
+         -10,   0,  10,  10,  10,  10,   0, -10,
+         -10,   0,  10,  10,  10,  10,   0, -10,
+         -10,   5,  10,  10,  10,  10,   5, -10,
+         -10,  10,   0,   5,   5,   0,  10, -10,
+         -20, -10, -10, -10, -10, -10, -10, -20,
+    },
+    { // torre
+           0,   0,   5,  10,  10,   5,   0,   0,
+          -5,   0,   0,   0,   0,   0,   0,  -5,
+          -5,   0,   0,   0,   0,   0,   0,  -5,
+          -5,   0,   0,   5,   5,   0,   0,  -5,
+          -5,   0,   0,   5,   5,   0,   0,  -5,
+          -5,   0,   0,   0,   0,   0,   0,  -5,
+           5,  10,  10,  10,  10,  10,  10,   5,
+           0,   0,   0,   0,   0,   0,   0,   0,
+    },
+    { // dama
+         -20, -10, -10,  -5,  -5, -10, -10, -20,
+         -10,   0,   5,   0,   0,   0,   0, -10,
+         -10,   5,   5,   5,   5,   5,   0, -10,
+          -5,   0,   5,   5,   5,   5,   0,  -5,
+          -5,   0,   5,   5,   5,   5,   0,  -5,
+         -10,   0,   5,   5,   5,   5,   0, -10,
+         -10,   0,   0,   0,   0,   0,   0, -10,
+         -20, -10, -10,  -5,  -5, -10, -10, -20,
+    },
+    { // rei (meio-jogo)
+         -30, -40, -40, -50, -50, -40, -40, -30,
+         -30, -40, -40, -50, -50, -40, -40, -30,
+         -30, -40, -40, -50, -50, -40, -40, -30,
+         -30, -40, -40, -50, -50, -40, -40, -30,
+         -20, -30, -30, -40, -40, -30, -30, -20,
+         -10, -20, -20, -20, -20, -20, -20, -10,
+          20,  20,   0,   0,   0,   0,  20,  20,
+          20,  30,  10,   0,   0,  10,  30,  20,
+    },
+    { // rei (final)
+         -50, -30, -30, -30, -30, -30, -30, -50,
+         -30, -20, -10,   0,   0, -10, -20, -30,
+         -30, -10,  20,  30,  30,  20, -10, -30,
+         -30, -10,  30,  40,  40,  30, -10, -30,
+         -30, -10,  30,  40,  40,  30, -10, -30,
+         -30, -10,  20,  30,  30,  20, -10, -30,
+         -30, -30, -10,   0,   0, -10, -30, -30,
+         -50, -30, -30, -30, -30, -30, -30, -50,
+    },
+};
+
+static const int EVAL_BISHOP_PAIR = 25;
+static const int EVAL_MOBILITY    = 2; // por casa livre de torre/dama na horizontal/vertical
+
+#endif // DEEPBECKY_EVAL_PARAMS_H
@@ -0,0 +1,168 @@
+/*
+ * Deep Becky 0.2 - UCI Chess Engine
+ * Copyright (C) 2025-2026 Diogo de Oliveira Almeida
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ */
+
+// ============ Geração de posições (gensfen) ============
+// deepbecky gensfen --out data.bin [--count N] [--nodes N] [--threads T]
+//                   [--random-plies N] [--max-plies N] [--hash MB] [--seed S]
+// deepbecky gensfen --dump data.bin [--limit N]
+//
+// T partidas de auto-jogo em paralelo, cada uma com engine própria: alguns
+// lances aleatórios de abertura e depois busca limitada a N nós por lance.
+// Cada posição (fora de xeque) vira um PackedPos de 32 bytes com o score da
+// busca e o lance escolhido; o resultado entra quando a partida termina.
+#include "engine.h"
+
+namespace {
+
+struct GenOptions {
+    long long count = 1000000;
+    long long nodes = 5000;
+    int randomPlies = 8;
+    int maxPlies = 400;
+    int openingLimit = 400; // descarta aberturas aleatórias já decididas (cp)
+    int hashMB = 16;
+    uint64_t seed = 0;
+};
+
+// Resultado (brancas: 1/0/-1) de uma partida de auto-jogo; posições em game.
+// Retorna false se a abertura aleatória foi descartada.
+bool playGame(DeepBeckyEngine& e, const GenOptions& o, mt19937_64& rng,
+              vector<PackedPos>& game, int& result, const atomic<bool>& stop){
+    e.setStartPos();
+    e.clearTT();
+    e.clearHeuristics();
+    game.clear();
+
+    int rp = o.randomPlies>2? o.randomPlies - (int)(rng()%3) : o.randomPlies;
+    for(int i=0;i<rp;i++){
+        vector<Move> l = e.generateLegal();
+        if(l.empty()) return false;
+        e.makeMove(l[rng()%l.size()]);
+    }
+
+    SearchLimits lim;
+    lim.nodes = o.nodes;
+    result = 0;
+    for(int ply=0; ply<o.maxPlies; ply++){
+        if(stop) return false;
+        bool checked = e.inCheck(e.white_to_move);
+        if(e.generateLegal().empty()){
+            if(checked) result = e.white_to_move? -1 : 1;
+            return true;
+        }
+        if(e.isDraw(0) || e.insufficientMaterial()) return true;
+
+        Move bm = e.go(lim);
+        const auto& rm = e.root_moves[0];
+        int sc = rm.score!=-INF_SCORE? rm.score : rm.prev_score;
+        if(ply==0 && abs(sc) > o.openingLimit) return false;
+        if(!checked) game.push_back(e.pack(sc, bm, 0));
+        // mate visto pela busca: adjudica
+        if(abs(sc) >= MATE_IN_MAX){
+            int stm = e.white_to_move? 1 : -1;
+            result = sc>0? stm : -stm;
+            return true;
+        }
+        e.makeMove(bm);
+    }
+    return true; // limite de plies = empate
+}
+
+int dump(const string& path, long long limit){
+    SfenReader r;
+    if(!r.open(path)){ cerr << "cannot open " << path << endl; return 1; }
+    DeepBeckyEngine e(1);
+    PackedPos p;
+    for(long long i=0; (limit<=0 || i<limit) && r.next(p); i++){
+        e.unpack(p);
+        cout << e.getFEN() << " ; score " << p.score << " ; move " << packedToUCI(p.move)
+             << " ; result " << (int)p.result << '\n';
+    }
+    return 0;
+}
+
+} // namespace
+
+int runGensfen(int argc, char** argv){
+    GenOptions o;
+    string outPath, dumpPath;
+    long long limit = 0;
+    int threads = max(1u, thread::hardware_concurrency());
+    o.seed = (uint64_t)chrono::high_resolution_clock::now().time_since_epoch().count();
+    for(int i=2;i<argc;i++){
+        string a=argv[i];
+        auto next=[&](){ return (i+1<argc)? string(argv[++i]) : string(); };
+        if(a=="--out") outPath=next();
+        else if(a=="--dump") dumpPath=next();
+        else if(a=="--limit") limit=atoll(next().c_str());
+        else if(a=="--count") o.count=atoll(next().c_str());
+        else if(a=="--nodes") o.nodes=max(1LL, atoll(next().c_str()));
+        else if(a=="--threads") threads=atoi(next().c_str());
+        else if(a=="--random-plies") o.randomPlies=max(0, atoi(next().c_str()));
+        else if(a=="--max-plies") o.maxPlies=max(1, atoi(next().c_str()));
+        else if(a=="--hash") o.hashMB=max(1, atoi(next().c_str()));
+        else if(a=="--seed") o.seed=strtoull(next().c_str(), nullptr, 10);
+    }
+    if(!dumpPath.empty()) return dump(dumpPath, limit);
+    if(outPath.empty()){
+        cerr << "usage: deepbecky gensfen --out data.bin [--count N] [--nodes N] [--threads T] [--random-plies N]"
+                " [--max-plies N] [--hash MB] [--seed S]\n"
+                "       deepbecky gensfen --dump data.bin [--limit N]" << endl;
+        return 1;
+    }
+    threads = max(1, min(threads, 256));
+
+    SfenWriter writer;
+    if(!writer.open(outPath)){ cerr << "cannot write " << outPath << endl; return 1; }
+
+    atomic<bool> stop{false};
+    atomic<long long> games{0};
+    auto t0 = chrono::high_resolution_clock::now();
+    auto worker=[&](int tid){
+        DeepBeckyEngine e((size_t)o.hashMB);
+        e.quiet_info = true;
+        e.own_book = false;
+        mt19937_64 rng(o.seed + 0x9E3779B97F4A7C15ULL*(tid+1));
+        vector<PackedPos> game;
+        while(!stop){
+            int result;
+            if(!playGame(e, o, rng, game, result, stop)) continue;
+            for(auto& p: game) p.result = (int8_t)((p.flags&1)? -result : result);
+            writer.write(game.data(), game.size());
+            games++;
+            if(writer.count() >= o.count) stop = true;
+        }
+    };
+    vector<thread> pool;
+    for(int i=0;i<threads;i++) pool.emplace_back(worker, i);
+
+    auto elapsed=[&](){ return chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now()-t0).count(); };
+    long long lastReport = 0;
+    while(!stop){
+        this_thread::sleep_for(chrono::milliseconds(200));
+        long long ms = elapsed();
+        if(ms - lastReport >= 5000){
+            lastReport = ms;
+            cerr << writer.count() << " positions, " << games << " games, "
+                 << (long long)(writer.count()*1000.0/max(1LL, ms)) << " pos/s" << endl;
+        }
+    }
+    for(auto& t: pool) t.join();
+    writer.close();
+    long long ms = elapsed();
+    cerr << "wrote " << writer.count() << " positions from " << games << " games in " << ms << " ms ("
+         << (long long)(writer.count()*1000.0/max(1LL, ms)) << " pos/s, " << threads << " threads)" << endl;
+    return 0;
+}
@@ -0,0 +1,465 @@
+/*
+ * Deep Becky 0.2 - UCI Chess Engine
+ * Copyright (C) 2025-2026 Diogo de Oliveira Almeida
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ */
+
+// ============ Partidas engine x engine (match) ============
+// deepbecky match --a SPEC --b SPEC [--games N] [--concurrency T] [--openings book.epd]
+//                 [--nodes N | --movetime ms | --depth D] [--hash MB] [--max-plies N]
+//                 [--sprt ELO0,ELO1] [--alpha A] [--beta B] [--random-plies N] [--seed S]
+// SPEC: "default" (pesos embutidos), "params:arquivo.h" (formato eval_params.h,
+// ex.: saída do tune) ou "cmd:binário" (engine UCI externa via pipes).
+//
+// Cada abertura é jogada duas vezes com as cores trocadas; T pares de
+// jogadores em paralelo. O árbitro é uma DeepBeckyEngine que valida os lances
+// com o gerador legal e adjudica mate, afogamento, repetição, 50 lances e
+// material insuficiente. Com --sprt o match para sozinho ao cruzar um limite.
+#include "engine.h"
+
+#ifdef _WIN32
+  #ifndef NOMINMAX
+    #define NOMINMAX
+  #endif
+  #include <windows.h>
+#else
+  #include <csignal>
+  #include <sys/wait.h>
+  #include <unistd.h>
+#endif
+
+namespace {
+
+struct MatchOptions {
+    string specA = "default", specB = "default";
+    long long games = 100;
+    int concurrency = 1;
+    string openings;
+    int randomPlies = 8;  // sem --openings: aberturas aleatórias
+    SearchLimits limits;
+    int hashMB = 16;
+    int maxPlies = 400;   // limite de plies = empate
+    bool sprt = false;
+    double elo0 = 0, elo1 = 5, alpha = 0.05, beta = 0.05;
+    uint64_t seed = 0;
+};
+
+// ============ Jogadores ============
+class Player {
+public:
+    virtual ~Player() = default;
+    virtual bool newGame() = 0;
+    // Lance em UCI para a posição fen + moves; vazio em caso de falha.
+    virtual string bestMove(const string& fen, const vector<string>& moves) = 0;
+};
+
+class InternalPlayer : public Player {
+    DeepBeckyEngine e;
+    SearchLimits lim;
+public:
+    InternalPlayer(const EvalParams* params, const MatchOptions& o) : e((size_t)o.hashMB), lim(o.limits){
+        e.eval = params;
+        e.quiet_info = true;
+        e.own_book = false;
+    }
+    bool newGame() override { e.clearTT(); e.clearHeuristics(); return true; }
+    string bestMove(const string& fen, const vector<string>& moves) override {
+        e.setPosition(fen, moves);
+        return e.moveToUCI(e.go(lim));
+    }
+};
+
+// Processo filho com stdin/stdout ligados a pipes.
+class ChildProcess {
+#ifdef _WIN32
+    HANDLE proc = nullptr, in = nullptr, out = nullptr;
+#else
+    pid_t pid = -1;
+    int in = -1, out = -1;
+#endif
+    string buf;
+public:
+    ~ChildProcess(){ close(); }
+    bool start(const string& cmd);
+    bool writeLine(const string& s);
+    bool readLine(string& line);
+    void close();
+};
+
+#ifdef _WIN32
+bool ChildProcess::start(const string& cmd){
+    SECURITY_ATTRIBUTES sa{ sizeof(sa), nullptr, TRUE };
+    HANDLE childIn, childOut;
+    if(!CreatePipe(&childIn, &in, &sa, 0)) return false;
+    if(!CreatePipe(&out, &childOut, &sa, 0)){ CloseHandle(childIn); CloseHandle(in); in=nullptr; return false; }
+    SetHandleInformation(in, HANDLE_FLAG_INHERIT, 0);
+    SetHandleInformation(out, HANDLE_FLAG_INHERIT, 0);
+    STARTUPINFOA si{}; si.cb = sizeof(si);
+    si.dwFlags = STARTF_USESTDHANDLES;
+    si.hStdInput = childIn; si.hStdOutput = childOut; si.hStdError = GetStdHandle(STD_ERROR_HANDLE);
+    PROCESS_INFORMATION pi{};
+    string line = cmd;
+    BOOL ok = CreateProcessA(nullptr, &line[0], nullptr, nullptr, TRUE, CREATE_NO_WINDOW, nullptr, nullptr, &si, &pi);
+    CloseHandle(childIn); CloseHandle(childOut);
+    if(!ok){ close(); return false; }
+    CloseHandle(pi.hThread);
+    proc = pi.hProcess;
+    return true;
+}
+bool ChildProcess::writeLine(const string& s){
+    string l = s + "\n";
+    DWORD w;
+    return in && WriteFile(in, l.data(), (DWORD)l.size(), &w, nullptr) && w==l.size();
+}
+bool ChildProcess::readLine(string& line){
+    for(;;){
+        size_t nl = buf.find('\n');
+        if(nl!=string::npos){
+            line = buf.substr(0, nl);
+            if(!line.empty() && line.back()=='\r') line.pop_back();
+            buf.erase(0, nl+1);
+            return true;
+        }
+        char tmp[4096]; DWORD r;
+        if(!out || !ReadFile(out, tmp, sizeof(tmp), &r, nullptr) || r==0) return false;
+        buf.append(tmp, r);
+    }
+}
+void ChildProcess::close(){
+    if(in){ CloseHandle(in); in=nullptr; }
+    if(out){ CloseHandle(out); out=nullptr; }
+    if(proc){
+        if(WaitForSingleObject(proc, 2000)!=WAIT_OBJECT_0) TerminateProcess(proc, 1);
+        CloseHandle(proc); proc=nullptr;
+    }
+}
+#else
+bool ChildProcess::start(const string& cmd){
+    signal(SIGPIPE, SIG_IGN); // engine que morre vira erro de escrita, não sinal
+    int toChild[2], fromChild[2];
+    if(pipe(toChild)) return false;
+    if(pipe(fromChild)){ ::close(toChild[0]); ::close(toChild[1]); return false; }
+    pid = fork();
+    if(pid==0){
+        dup2(toChild[0], 0); dup2(fromChild[1], 1);
+        ::close(toChild[0]); ::close(toChild[1]); ::close(fromChild[0]); ::close(fromChild[1]);
+        execl("/bin/sh", "sh", "-c", ("exec " + cmd).c_str(), (char*)nullptr);
+        _exit(127);
+    }
+    ::close(toChild[0]); ::close(fromChild[1]);
+    in = toChild[1]; out = fromChild[0];
+    if(pid<0){ close(); return false; }
+    return true;
+}
+bool ChildProcess::writeLine(const string& s){
+    string l = s + "\n";
+    for(size_t off=0; off<l.size(); ){
+        ssize_t w = ::write(in, l.data()+off, l.size()-off);
+        if(w<=0) return false;
+        off += (size_t)w;
+    }
+    return true;
+}
+bool ChildProcess::readLine(string& line){
+    for(;;){
+        size_t nl = buf.find('\n');
+        if(nl!=string::npos){
+            line = buf.substr(0, nl);
+            if(!line.empty() && line.back()=='\r') line.pop_back();
+            buf.erase(0, nl+1);
+            return true;
+        }
+        char tmp[4096];
+        ssize_t r = ::read(out, tmp, sizeof(tmp));
+        if(r<=0) return false;
+        buf.append(tmp, (size_t)r);
+    }
+}
+void ChildProcess::close(){
+    if(in>=0){ ::close(in); in=-1; }
+    if(out>=0){ ::close(out); out=-1; }
+    if(pid>0){
+        int st;
+        for(int i=0;i<200 && waitpid(pid, &st, WNOHANG)==0;i++) this_thread::sleep_for(chrono::milliseconds(10));
+        if(waitpid(pid, &st, WNOHANG)==0){ kill(pid, SIGKILL); waitpid(pid, &st, 0); }
+        pid=-1;
+    }
+}
+#endif
+
+class UciPlayer : public Player {
+    ChildProcess p;
+    string go;
+    bool ok = false;
+    bool waitFor(const string& token){
+        string l;
+        while(p.readLine(l)) if(l.compare(0, token.size(), token)==0) return true;
+        return false;
+    }
+public:
+    UciPlayer(const string& cmd, const MatchOptions& o){
+        ostringstream g;
+        g << "go";
+        if(o.limits.nodes>0) g << " nodes " << o.limits.nodes;
+        if(o.limits.depth>0) g << " depth " << o.limits.depth;
+        if(o.limits.movetime>0) g << " movetime " << o.limits.movetime;
+        go = g.str();
+        ok = p.start(cmd) && p.writeLine("uci") && waitFor("uciok")
+          && p.writeLine("setoption name Hash value " + to_string(o.hashMB));
+    }
+    ~UciPlayer() override { if(ok) p.writeLine("quit"); }
+    bool newGame() override {
+        return ok && p.writeLine("ucinewgame") && p.writeLine("isready") && waitFor("readyok");
+    }
+    string bestMove(const string& fen, const vector<string>& moves) override {
+        string pos = "position fen " + fen;
+        if(!moves.empty()){ pos += " moves"; for(auto& m: moves) pos += " " + m; }
+        if(!ok || !p.writeLine(pos) || !p.writeLine(go)) return "";
+        string l;
+        while(p.readLine(l)){
+            if(l.compare(0, 9, "bestmove ")) continue;
+            istringstream ss(l.substr(9));
+            string m; ss >> m;
+            return m;
+        }
+        return "";
+    }
+};
+
+struct PlayerSpec {
+    string cmd;        // engine externa
+    EvalParams params; // engine interna
+};
+
+bool parseSpec(const string& s, PlayerSpec& out){
+    if(s=="default"){ out.params = EVAL_DEFAULT; return true; }
+    if(s.compare(0, 7, "params:")==0) return loadEvalParams(s.substr(7), out.params);
+    if(s.compare(0, 4, "cmd:")==0){ out.cmd = s.substr(4); return !out.cmd.empty(); }
+    return false;
+}
+
+unique_ptr<Player> makePlayer(const PlayerSpec& s, const MatchOptions& o){
+    if(!s.cmd.empty()) return unique_ptr<Player>(new UciPlayer(s.cmd, o));
+    return unique_ptr<Player>(new InternalPlayer(&s.params, o));
+}
+
+// ============ Aberturas ============
+vector<string> loadOpenings(const string& path){
+    vector<string> fens;
+    ifstream in(path);
+    string line;
+    while(getline(in, line)){
+        istringstream ss(line);
+        string f[4], hm, fm;
+        if(!(ss >> f[0] >> f[1] >> f[2] >> f[3])) continue;
+        // EPD não traz relógios; FEN completo traz.
+        string fen = f[0]+" "+f[1]+" "+f[2]+" "+f[3];
+        if(ss >> hm >> fm && isdigit((unsigned char)hm[0]) && isdigit((unsigned char)fm[0])) fen += " "+hm+" "+fm;
+        else fen += " 0 1";
+        fens.push_back(fen);
+    }
+    return fens;
+}
+
+// Abertura aleatória de n plies a partir da posição inicial (FEN).
+string randomOpening(DeepBeckyEngine& ref, int n, mt19937_64& rng){
+    for(;;){
+        ref.setStartPos();
+        bool ok = true;
+        for(int i=0;i<n && ok;i++){
+            vector<Move> l = ref.generateLegal();
+            if(l.empty()) ok = false;
+            else ref.makeMove(l[rng()%l.size()]);
+        }
+        if(ok && !ref.generateLegal().empty()) return ref.getFEN();
+    }
+}
+
+// ============ Partida ============
+enum GameEnd { END_MATE, END_STALEMATE, END_REPETITION, END_FIFTY, END_MATERIAL, END_MAXPLIES, END_ILLEGAL, END_NO_ENGINE };
+const char* END_NAME[] = { "mate", "stalemate", "repetition", "50 moves", "insufficient material", "max plies", "illegal move", "engine failed" };
+
+// Resultado do ponto de vista das brancas (1/0/-1). END_NO_ENGINE: um jogador
+// não conseguiu começar a partida (engine que não sobe ou morreu); não conta.
+int playGame(DeepBeckyEngine& ref, Player* white, Player* black, const string& fen,
+             const MatchOptions& o, GameEnd& end){
+    vector<string> moves;
+    ref.setFEN(fen);
+    if(!white->newGame() || !black->newGame()){ end = END_NO_ENGINE; return 0; }
+    for(int ply=0;;ply++){
+        bool wtm = ref.white_to_move;
+        vector<Move> legal = ref.generateLegal();
+        if(legal.empty()){
+            if(ref.inCheck(wtm)){ end = END_MATE; return wtm? -1 : 1; }
+            end = END_STALEMATE; return 0;
+        }
+        if(ref.halfmove>=100){ end = END_FIFTY; return 0; }
+        if(ref.isDraw(0)){ end = END_REPETITION; return 0; }
+        if(ref.insufficientMaterial()){ end = END_MATERIAL; return 0; }
+        if(ply>=o.maxPlies){ end = END_MAXPLIES; return 0; }
+
+        string uci = (wtm? white : black)->bestMove(fen, moves);
+        Move want = ref.uciToMove(uci), m;
+        if(uci.empty() || !ref.findLegal(want, m)){
+            cerr << "illegal move '" << uci << "' by " << (wtm? "white" : "black") << " in " << ref.getFEN() << endl;
+            end = END_ILLEGAL; return wtm? -1 : 1;
+        }
+        ref.makeMove(m);
+        moves.push_back(uci);
+    }
+}
+
+// ============ Estatística ============
+struct Score {
+    long long w=0, d=0, l=0; // do ponto de vista de A
+    long long n() const { return w+d+l; }
+    double mean() const { return n()? (w + 0.5*d)/n() : 0.5; }
+    double variance() const { // por partida
+        double m = mean(), N = (double)max(1LL, n());
+        return (w*(1-m)*(1-m) + d*(0.5-m)*(0.5-m) + l*m*m) / N;
+    }
+};
+
+double eloToScore(double elo){ return 1.0 / (1.0 + pow(10.0, -elo/400.0)); }
+double scoreToElo(double s){
+    s = min(max(s, 1e-6), 1.0-1e-6);
+    return -400.0 * log10(1.0/s - 1.0);
+}
+
+// GSPRT com aproximação normal do modelo trinomial (W/D/L): razão de
+// verossimilhança entre Elo = elo0 e Elo = elo1 (logístico). Meia partida
+// a priori em cada resultado evita variância nula (só vitórias, só empates),
+// então placares unilaterais também encerram o teste.
+double llr(const Score& s, double elo0, double elo1){
+    if(!s.n()) return 0;
+    double w = s.w + 0.5, d = s.d + 0.5, l = s.l + 0.5, N = w + d + l;
+    double m = (w + 0.5*d) / N;
+    double var = (w*(1-m)*(1-m) + d*(0.5-m)*(0.5-m) + l*m*m) / N / N;
+    double s0 = eloToScore(elo0), s1 = eloToScore(elo1);
+    return (s1-s0) * (2*m - s0 - s1) / (2*var);
+}
+
+} // namespace
+
+int runMatch(int argc, char** argv){
+    MatchOptions o;
+    o.limits.nodes = 10000;
+    o.seed = (uint64_t)chrono::high_resolution_clock::now().time_since_epoch().count();
+    for(int i=2;i<argc;i++){
+        string a=argv[i];
+        auto next=[&](){ return (i+1<argc)? string(argv[++i]) : string(); };
+        if(a=="--a") o.specA=next();
+        else if(a=="--b") o.specB=next();
+        else if(a=="--games") o.games=max(1LL, atoll(next().c_str()));
+        else if(a=="--concurrency") o.concurrency=atoi(next().c_str());
+        else if(a=="--openings") o.openings=next();
+        else if(a=="--random-plies") o.randomPlies=max(0, atoi(next().c_str()));
+        else if(a=="--nodes"){ o.limits=SearchLimits(); o.limits.nodes=max(1LL, atoll(next().c_str())); }
+        else if(a=="--movetime"){ o.limits=SearchLimits(); o.limits.movetime=max(1, atoi(next().c_str())); }
+        else if(a=="--depth"){ o.limits=SearchLimits(); o.limits.depth=max(1, atoi(next().c_str())); }
+        else if(a=="--hash") o.hashMB=max(1, atoi(next().c_str()));
+        else if(a=="--max-plies") o.maxPlies=max(1, atoi(next().c_str()));
+        else if(a=="--sprt"){
+            string v=next();
+            o.sprt = sscanf(v.c_str(), "%lf,%lf", &o.elo0, &o.elo1)==2 && o.elo1>o.elo0;
+            if(!o.sprt){ cerr << "bad --sprt " << v << " (expected ELO0,ELO1 with ELO1 > ELO0)" << endl; return 1; }
+        }
+        else if(a=="--alpha") o.alpha=atof(next().c_str());
+        else if(a=="--beta") o.beta=atof(next().c_str());
+        else if(a=="--seed") o.seed=strtoull(next().c_str(), nullptr, 10);
+        else{
+            cerr << "usage: deepbecky match --a SPEC --b SPEC [--games N] [--concurrency T] [--openings book.epd]"
+                    " [--nodes N | --movetime ms | --depth D] [--hash MB] [--max-plies N]"
+                    " [--sprt ELO0,ELO1] [--alpha A] [--beta B] [--random-plies N] [--seed S]\n"
+                    "  SPEC = default | params:eval_params.h | cmd:/path/to/uci-engine" << endl;
+            return 1;
+        }
+    }
+    PlayerSpec A, B;
+    if(!parseSpec(o.specA, A)){ cerr << "bad player spec " << o.specA << endl; return 1; }
+    if(!parseSpec(o.specB, B)){ cerr << "bad player spec " << o.specB << endl; return 1; }
+    o.concurrency = max(1, min(o.concurrency, 256));
+    o.games += o.games&1; // pares completos
+
+    vector<string> openings;
+    if(!o.openings.empty()){
+        openings = loadOpenings(o.openings);
+        if(openings.empty()){ cerr << "no openings in " << o.openings << endl; return 1; }
+    }
+    double lower = log(o.beta/(1-o.alpha)), upper = log((1-o.beta)/o.alpha);
+
+    mutex mtx;
+    Score score;
+    long long ends[END_NO_ENGINE+1] = {};
+    atomic<long long> nextPair{0};
+    atomic<bool> stop{false};
+    int verdict = 0; // SPRT: 1 = H1 aceita, -1 = H0 aceita
+    bool failed = false; // jogador quebrado: aborta em vez de somar empates
+    auto t0 = chrono::high_resolution_clock::now();
+
+    auto report=[&](ostream& out){
+        double m = score.mean(), err = 1.96*sqrt(score.variance()/max(1LL, score.n()));
+        out << "Games " << score.n() << ": +" << score.w << " -" << score.l << " =" << score.d
+            << "  score " << fixed << setprecision(1) << 100*m << "%"
+            << "  elo " << setprecision(1) << scoreToElo(m) + 0.0
+            << " +/- " << (scoreToElo(min(m+err, 1.0)) - scoreToElo(max(m-err, 0.0)))/2;
+        if(o.sprt) out << "  LLR " << setprecision(2) << llr(score, o.elo0, o.elo1)
+                       << " (" << lower << ", " << upper << ")";
+        out << defaultfloat << setprecision(6) << endl;
+    };
+
+    auto worker=[&](int tid){
+        DeepBeckyEngine ref(1);
+        ref.quiet_info = true;
+        mt19937_64 rng(o.seed + 0x9E3779B97F4A7C15ULL*(tid+1));
+        unique_ptr<Player> pa = makePlayer(A, o), pb = makePlayer(B, o);
+        while(!stop){
+            long long pair = nextPair++;
+            if(pair*2 >= o.games) break;
+            string fen = openings.empty()? (o.randomPlies? randomOpening(ref, o.randomPlies, rng)
+                                                         : string("rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"))
+                                         : openings[(size_t)(pair % (long long)openings.size())];
+            for(int g=0; g<2 && !stop; g++){
+                GameEnd end;
+                bool aWhite = g==0;
+                int r = playGame(ref, aWhite? pa.get() : pb.get(), aWhite? pb.get() : pa.get(), fen, o, end);
+                int ra = aWhite? r : -r;
+                lock_guard<mutex> lk(mtx);
+                if(end==END_NO_ENGINE){
+                    if(!failed) cerr << "a player could not start a game; aborting the match" << endl;
+                    failed = true; stop = true;
+                    break;
+                }
+                if(ra>0) score.w++; else if(ra<0) score.l++; else score.d++;
+                ends[end]++;
+                report(cerr);
+                if(o.sprt){
+                    double v = llr(score, o.elo0, o.elo1);
+                    if(v>=upper){ verdict = 1; stop = true; }
+                    else if(v<=lower){ verdict = -1; stop = true; }
+                }
+            }
+        }
+    };
+    vector<thread> pool;
+    for(int i=0;i<o.concurrency;i++) pool.emplace_back(worker, i);
+    for(auto& t: pool) t.join();
+
+    long long ms = chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now()-t0).count();
+    cout << "Finished " << o.specA << " vs " << o.specB << " in " << ms << " ms" << endl;
+    report(cout);
+    for(int e=0;e<END_NO_ENGINE;e++) if(ends[e]) cout << "  " << END_NAME[e] << ": " << ends[e] << endl;
+    if(failed){ cout << "Aborted: a player failed to start a game" << endl; return 1; }
+    if(o.sprt) cout << "SPRT [" << o.elo0 << ", " << o.elo1 << "]: "
+                    << (verdict>0? "H1 accepted" : verdict<0? "H0 accepted" : "inconclusive") << endl;
+    return 0;
+}
@@ -0,0 +1,498 @@
+/*
+ * Deep Becky 0.2 - UCI Chess Engine
+ * Copyright (C) 2025-2026 Diogo de Oliveira Almeida
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ */
+
+// ============ Servidor multi-partida (server / connect) ============
+// deepbecky server --socket PATH [--workers N] [--hash-budget MB] [--max-games N]
+// deepbecky connect --socket PATH
+//
+// Um processo atende muitas sessões UCI por socket Unix. Cada sessão tem a
+// sua DeepBeckyEngine (posição, heurísticas, TT); um thread de I/O lê todos
+// os sockets com poll() e as buscas vão para uma fila FIFO atendida por N
+// workers. O orçamento de hash é dividido entre as sessões abertas: quando
+// uma entra ou sai, a fatia de cada uma (limitada pela opção Hash dela) muda
+// e a TT é reorganizada por rehashTT no worker, no início do próximo "go"
+// da sessão. Encolher é sempre permitido; crescer só com MB livres, então a
+// soma das TTs não passa do orçamento nem enquanto outra sessão ainda não
+// encolheu (fora a cópia durante o próprio rehash). O tempo de fila e do
+// rehash é descontado do relógio do "go", então a carga não estoura o tempo.
+// isready é respondido na hora pelo I/O; stop liga o halt da engine, que a
+// busca não zera.
+// "connect" liga stdin/stdout ao socket, para GUIs que só rodam um binário.
+#include "engine.h"
+
+#ifdef _WIN32
+
+int runServer(int, char**){
+    cerr << "server mode needs Unix domain sockets (POSIX only)" << endl;
+    return 1;
+}
+int runConnect(int, char**){
+    cerr << "connect needs Unix domain sockets (POSIX only)" << endl;
+    return 1;
+}
+
+#else
+
+#include <condition_variable>
+#include <deque>
+#include <csignal>
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+struct ServerOptions {
+    string socket;
+    int workers = 1;
+    size_t hashBudget = 1024;  // MB para todas as sessões
+    int maxGames = 256;
+};
+
+// ============ Sessão ============
+// Fora de uma tarefa só o thread de I/O mexe na engine; com busy ligado ela
+// pertence ao worker, e o I/O só pode ligar halt.
+struct Session {
+    int id = 0, fd = -1;
+    unique_ptr<DeepBeckyEngine> e;
+    string inbuf;
+    struct Pending { string line; uint64_t seq; };
+    deque<Pending> pending;          // comandos que esperam a tarefa atual
+    bool busy = false;                // go com um worker
+    bool closing = false, eof = false;
+    size_t want_mb = DEFAULT_HASH_MB; // opção Hash: teto da fatia
+    size_t target_mb = 1;             // fatia atual do orçamento
+    size_t held_mb = 1;               // reservado no orçamento (TT atual ou a caminho)
+
+    // go: seq de recebimento; stop/quit cancelam todo go com seq <= stopped
+    uint64_t go_seq = 0;
+    atomic<uint64_t> stopped{0};
+    atomic<bool> halt{false};         // e->halt: corta a busca em andamento
+
+    // Tarefa em andamento (preenchida pelo I/O antes de enfileirar)
+    size_t job_mb = 1;                // tamanho da TT para a tarefa
+    uint64_t job_seq = 0;
+    SearchLimits job_lim;
+    chrono::steady_clock::time_point job_queued;
+
+    mutex out_mx;
+    void send(const string& s){
+        lock_guard<mutex> lk(out_mx);
+        size_t off = 0;
+        while(off < s.size()){
+            ssize_t n = ::send(fd, s.data()+off, s.size()-off, 0);
+            if(n<=0){ if(n<0 && errno==EINTR) continue; return; }
+            off += (size_t)n;
+        }
+    }
+};
+typedef shared_ptr<Session> SessionPtr;
+
+// ============ Workers ============
+class WorkerPool {
+public:
+    explicit WorkerPool(int n, function<void(const SessionPtr&)> done) : onDone(move(done)) {
+        for(int i=0;i<n;i++) threads.emplace_back([this]{ loop(); });
+    }
+    ~WorkerPool(){
+        { lock_guard<mutex> lk(mx); quit = true; }
+        cv.notify_all();
+        for(auto& t: threads) t.join();
+    }
+    void post(const SessionPtr& s){
+        { lock_guard<mutex> lk(mx); q.push_back(s); }
+        cv.notify_one();
+    }
+
+private:
+    mutex mx;
+    condition_variable cv;
+    deque<SessionPtr> q;
+    bool quit = false;
+    vector<thread> threads;
+    function<void(const SessionPtr&)> onDone;
+
+    void loop(){
+        for(;;){
+            SessionPtr s;
+            {
+                unique_lock<mutex> lk(mx);
+                cv.wait(lk, [this]{ return quit || !q.empty(); });
+                if(quit) return;
+                s = q.front(); q.pop_front();
+            }
+            runJob(*s);
+            onDone(s);
+        }
+    }
+
+    // Ajusta a TT à fatia, busca e responde.
+    static void runJob(Session& s){
+        DeepBeckyEngine& e = *s.e;
+        if(e.hash_mb != s.job_mb) e.rehashTT(s.job_mb);
+
+        SearchLimits lim = s.job_lim;
+        long long waited = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now()-s.job_queued).count();
+        if(waited>=10) s.send("info string queued " + to_string(waited) + " ms\n");
+        // Fila + rehash contam no relógio de quem joga
+        if(lim.movetime>0) lim.movetime = max(1LL, lim.movetime - waited);
+        int& clock = e.white_to_move? lim.wtime : lim.btime;
+        if(clock>0) clock = (int)max(1LL, clock - waited);
+        if(s.stopped >= s.job_seq){ // stop chegou ainda na fila: só um lance legal e rápido
+            lim = SearchLimits(); lim.depth = 1;
+            s.halt = false;
+        }
+
+        if(e.generateLegal().empty()){
+            s.send(string("info string ") + (e.inCheck(e.white_to_move)? "checkmate" : "stalemate") + "\nbestmove 0000\n");
+            return;
+        }
+        e.on_info = [&](int d, int k, const DeepBeckyEngine::RootMove& rm, long long ms){
+            s.send(e.infoLine(d, k, rm, ms) + "\n");
+        };
+        Move bm = e.go(lim);
+        e.on_info = nullptr;
+        if((bm.from_x|bm.from_y|bm.to_x|bm.to_y)==0) s.send("bestmove 0000\n");
+        else s.send("bestmove " + e.moveToUCI(bm) + "\n");
+    }
+};
+
+// ============ Servidor ============
+volatile sig_atomic_t g_quit = 0;
+int g_wake_w = -1;
+
+void onSignal(int){
+    g_quit = 1;
+    if(g_wake_w>=0){ ssize_t r = write(g_wake_w, "q", 1); (void)r; }
+}
+
+class Server {
+public:
+    explicit Server(const ServerOptions& o) : opt(o) {}
+
+    int run(){
+        if(!listenOn()) return 1;
+        int p[2];
+        if(pipe(p)!=0){ cerr << "pipe failed" << endl; return 1; }
+        wake_r = p[0]; wake_w = p[1]; g_wake_w = wake_w;
+        fcntl(wake_w, F_SETFL, O_NONBLOCK); // pipe cheio: o I/O já vai acordar
+        signal(SIGPIPE, SIG_IGN);
+        signal(SIGINT, onSignal);
+        signal(SIGTERM, onSignal);
+
+        {
+            WorkerPool pool(opt.workers, [this](const SessionPtr& s){
+                { lock_guard<mutex> lk(done_mx); done.push_back(s); }
+                ssize_t r = write(wake_w, "d", 1); (void)r;
+            });
+            workers = &pool;
+            cerr << "listening on " << opt.socket << " (" << opt.workers << " workers, "
+                 << opt.hashBudget << " MB hash budget)" << endl;
+            loop();
+            for(auto& kv: sessions) kv.second->halt = true;
+            workers = nullptr;
+        } // join dos workers
+        for(auto& kv: sessions) close(kv.second->fd);
+        sessions.clear();
+        close(listen_fd); close(wake_r); close(wake_w);
+        g_wake_w = -1;
+        unlink(opt.socket.c_str());
+        return 0;
+    }
+
+private:
+    ServerOptions opt;
+    int listen_fd = -1, wake_r = -1, wake_w = -1, next_id = 1;
+    map<int, SessionPtr> sessions; // fd -> sessão
+    WorkerPool* workers = nullptr;
+    mutex done_mx;
+    vector<SessionPtr> done;
+
+    bool listenOn(){
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if(opt.socket.size() >= sizeof(addr.sun_path)){ cerr << "socket path too long" << endl; return false; }
+        strcpy(addr.sun_path, opt.socket.c_str());
+        struct stat st;
+        if(lstat(opt.socket.c_str(), &st)==0){
+            if(!S_ISSOCK(st.st_mode)){ cerr << opt.socket << " exists and is not a socket" << endl; return false; }
+            unlink(opt.socket.c_str()); // socket velho de uma execução anterior
+        }
+        listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if(listen_fd<0 || bind(listen_fd, (sockaddr*)&addr, sizeof(addr))!=0 || listen(listen_fd, 64)!=0){
+            cerr << "cannot listen on " << opt.socket << ": " << strerror(errno) << endl;
+            if(listen_fd>=0) close(listen_fd);
+            return false;
+        }
+        return true;
+    }
+
+    void loop(){
+        vector<pollfd> fds;
+        vector<int> ids;
+        char buf[4096];
+        while(!g_quit){
+            fds.assign({ pollfd{listen_fd, POLLIN, 0}, pollfd{wake_r, POLLIN, 0} });
+            for(auto& kv: sessions) if(!kv.second->eof) fds.push_back(pollfd{kv.first, POLLIN, 0});
+            if(poll(fds.data(), fds.size(), -1)<0){
+                if(errno==EINTR) continue;
+                cerr << "poll: " << strerror(errno) << endl;
+                return;
+            }
+            if(fds[1].revents){ ssize_t r = read(wake_r, buf, sizeof(buf)); (void)r; finishJobs(); }
+            if(fds[0].revents & POLLIN) acceptOne();
+            for(size_t i=2;i<fds.size();i++){
+                if(!fds[i].revents) continue;
+                auto it = sessions.find(fds[i].fd);
+                if(it==sessions.end()) continue;
+                SessionPtr s = it->second;
+                ssize_t n = recv(s->fd, buf, sizeof(buf), 0);
+                if(n<=0){ s->eof = true; processPending(*s); maybeClose(s); continue; }
+                s->inbuf.append(buf, (size_t)n);
+                size_t nl;
+                while((nl = s->inbuf.find('\n'))!=string::npos){
+                    string line = s->inbuf.substr(0, nl);
+                    s->inbuf.erase(0, nl+1);
+                    if(!line.empty() && line.back()=='\r') line.pop_back();
+                    receive(*s, line);
+                }
+                maybeClose(s);
+            }
+        }
+    }
+
+    void acceptOne(){
+        int fd = accept(listen_fd, nullptr, nullptr);
+        if(fd<0) return;
+        if((int)sessions.size() >= opt.maxGames){
+            const char msg[] = "info string server full\n";
+            ssize_t r = ::send(fd, msg, sizeof(msg)-1, 0); (void)r;
+            close(fd);
+            return;
+        }
+        timeval tv{5, 0}; // cliente que não lê não trava um worker para sempre
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+        auto s = make_shared<Session>();
+        s->id = next_id++;
+        s->fd = fd;
+        s->e = make_unique<DeepBeckyEngine>(1);
+        s->e->quiet_info = true;
+        s->e->halt = &s->halt;
+        sessions[fd] = s;
+        rebalance();
+        cerr << "session " << s->id << " connected (" << sessions.size() << " open, "
+             << shareMB() << " MB hash each)" << endl;
+    }
+
+    // ===== Orçamento de hash =====
+    size_t shareMB() const {
+        size_t open = 0;
+        for(const auto& kv: sessions) open += !kv.second->closing;
+        return max<size_t>(1, opt.hashBudget / max<size_t>(1, open));
+    }
+    // Novas fatias; a TT só muda no próximo go de cada sessão (post).
+    void rebalance(){
+        size_t share = shareMB();
+        for(auto& kv: sessions){
+            Session& s = *kv.second;
+            if(!s.closing) s.target_mb = min(s.want_mb, share);
+        }
+    }
+
+    // Busca para o worker. A TT vai para a fatia: encolher sempre, crescer
+    // só até os MB que as outras sessões não reservam.
+    void post(Session& s){
+        size_t used = 0;
+        for(const auto& kv: sessions) used += kv.second->held_mb;
+        size_t free = opt.hashBudget > used? opt.hashBudget - used : 0;
+        s.busy = true;
+        s.halt = false;
+        s.job_mb = s.target_mb < s.held_mb? s.target_mb : min(s.target_mb, s.held_mb + free);
+        s.held_mb = max(s.held_mb, s.job_mb);
+        s.job_queued = chrono::steady_clock::now();
+        workers->post(sessions.at(s.fd));
+    }
+
+    // ===== Comandos =====
+    void receive(Session& s, const string& line){
+        stringstream ss(line);
+        string cmd; ss>>cmd;
+        if(cmd.empty() || s.closing) return;
+        if(cmd=="go") s.go_seq++;
+        if(cmd=="stop"){
+            s.stopped = s.go_seq;
+            if(s.busy) s.halt = true;
+            return;
+        }
+        if(cmd=="quit"){
+            s.closing = true;
+            s.stopped = s.go_seq;
+            if(s.busy) s.halt = true;
+            s.pending.clear();
+            rebalance();
+            return;
+        }
+        // Comandos seguintes ficam na fila da sessão, e a GUI já pode mandá-los
+        if(cmd=="isready"){ s.send("readyok\n"); return; }
+        s.pending.push_back({ line, s.go_seq });
+        processPending(s);
+    }
+
+    void processPending(Session& s){
+        while(!s.busy && !s.pending.empty()){
+            Session::Pending p = s.pending.front();
+            s.pending.pop_front();
+            execute(s, p.line, p.seq);
+        }
+    }
+
+    void execute(Session& s, const string& line, uint64_t seq){
+        DeepBeckyEngine& e = *s.e;
+        stringstream ss(line);
+        string cmd; ss>>cmd;
+        if(cmd=="uci"){
+            ostringstream os;
+            DeepBeckyEngine::printUciId(os);
+            s.send(os.str());
+        }
+        else if(cmd=="setoption"){
+            string name, value;
+            parseSetOption(ss, name, value);
+            if(name=="hash"){ // pedido, limitado pela fatia do orçamento
+                long long mb = DEFAULT_HASH_MB; stringstream(value)>>mb;
+                s.want_mb = (size_t)max(1LL, min<long long>(mb, MAX_HASH_MB));
+                rebalance();
+            }
+            else e.setOption(name, value);
+        }
+        else if(cmd=="ucinewgame"){
+            e.setStartPos();
+            if(!e.keep_hash) e.clearTT();
+            e.clearHeuristics();
+        }
+        else if(cmd=="position"){
+            string fen;
+            vector<string> moves;
+            parsePosition(ss, fen, moves);
+            size_t n = e.setPosition(fen, moves);
+            if(n<moves.size()) s.send("info string illegal move from GUI: " + moves[n] + "\n");
+        }
+        else if(cmd=="go"){
+            s.job_lim = parseGo(ss);
+            s.job_seq = seq;
+            post(s);
+        }
+        else if(cmd=="savehash" || cmd=="loadhash"){
+            s.send("info string " + cmd + " is not available in server mode\n");
+        }
+    }
+
+    // Tarefas concluídas pelos workers: libera a sessão e segue a fila dela.
+    void finishJobs(){
+        vector<SessionPtr> ready;
+        { lock_guard<mutex> lk(done_mx); ready.swap(done); }
+        for(const auto& sp: ready){
+            Session& s = *sp;
+            s.busy = false;
+            s.held_mb = s.e->hash_mb;
+            if(s.closing){ maybeClose(sp); continue; }
+            processPending(s);
+            maybeClose(sp);
+        }
+    }
+
+    void maybeClose(const SessionPtr& sp){
+        Session& s = *sp;
+        if(s.busy) return;
+        if(!s.closing && !(s.eof && s.pending.empty())) return;
+        close(s.fd);
+        sessions.erase(s.fd);
+        cerr << "session " << s.id << " closed (" << sessions.size() << " open)" << endl;
+        rebalance();
+    }
+};
+
+} // namespace
+
+int runServer(int argc, char** argv){
+    ServerOptions o;
+    o.workers = max(1u, thread::hardware_concurrency());
+    for(int i=2;i<argc;i++){
+        string a=argv[i];
+        auto next=[&](){ return (i+1<argc)? string(argv[++i]) : string(); };
+        if(a=="--socket") o.socket=next();
+        else if(a=="--workers") o.workers=max(1, atoi(next().c_str()));
+        else if(a=="--hash-budget") o.hashBudget=(size_t)max(1LL, atoll(next().c_str()));
+        else if(a=="--max-games") o.maxGames=max(1, atoi(next().c_str()));
+    }
+    if(o.socket.empty()){
+        cerr << "usage: deepbecky server --socket PATH [--workers N] [--hash-budget MB] [--max-games N]" << endl;
+        return 1;
+    }
+    Server srv(o);
+    return srv.run();
+}
+
+// Ponte stdin/stdout <-> socket. No fim do stdin só fecha a escrita: o
+// servidor termina a busca pendente, manda o bestmove e fecha.
+int runConnect(int argc, char** argv){
+    string path;
+    for(int i=2;i<argc;i++) if(string(argv[i])=="--socket" && i+1<argc) path=argv[++i];
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if(path.empty() || path.size() >= sizeof(addr.sun_path)){
+        cerr << "usage: deepbecky connect --socket PATH" << endl;
+        return 1;
+    }
+    strcpy(addr.sun_path, path.c_str());
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(fd<0 || connect(fd, (sockaddr*)&addr, sizeof(addr))!=0){
+        cerr << "cannot connect to " << path << ": " << strerror(errno) << endl;
+        return 1;
+    }
+    signal(SIGPIPE, SIG_IGN);
+    char buf[4096];
+    bool inOpen = true;
+    auto writeAll=[](int to, const char* p, size_t n){
+        while(n){
+            ssize_t w = write(to, p, n);
+            if(w<0 && errno==EINTR) continue;
+            if(w<=0) return false;
+            p += w; n -= (size_t)w;
+        }
+        return true;
+    };
+    for(;;){
+        pollfd fds[2] = { {fd, POLLIN, 0}, {inOpen? 0 : -1, POLLIN, 0} };
+        if(poll(fds, 2, -1)<0){ if(errno==EINTR) continue; break; }
+        if(fds[0].revents){
+            ssize_t n = read(fd, buf, sizeof(buf));
+            if(n<=0 || !writeAll(1, buf, (size_t)n)) break;
+        }
+        if(inOpen && fds[1].revents){
+            ssize_t n = read(0, buf, sizeof(buf));
+            if(n<=0){ inOpen = false; shutdown(fd, SHUT_WR); }
+            else if(!writeAll(fd, buf, (size_t)n)) break;
+        }
+    }
+    close(fd);
+    return 0;
+}
+
+#endif
@@ -0,0 +1,265 @@
+/*
+ * Deep Becky 0.2 - UCI Chess Engine
+ * Copyright (C) 2025-2026 Diogo de Oliveira Almeida
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ */
+
+// Microbench: mede cada primitiva do engine isolada (gerador, make/undo,
+// ataques, avaliação, hash, TT) sobre as posições fixas do bench.
+// Sem dependências; contadores de hardware opcionais via perf_event_open (Linux).
+//
+// Compilar: g++ -O3 -std=c++17 -pthread -I. tools/microbench.cpp engine.cpp -o microbench
+// Uso:      microbench [--rounds N] [--perf] [--json] [--only nome] [--hash MB]
+
+#include "engine.h"
+
+#ifdef __linux__
+  #include <linux/perf_event.h>
+  #include <sys/ioctl.h>
+  #include <sys/syscall.h>
+  #include <unistd.h>
+#endif
+
+static volatile uint64_t g_sink; // impede o compilador de descartar o trabalho
+
+// ============ Contadores de hardware ============
+static const int HW_NB = 4;
+static const char* HW_NAME[HW_NB] = { "cycles", "instructions", "branch_misses", "cache_misses" };
+
+struct PerfCounters {
+    int fd[HW_NB] = { -1, -1, -1, -1 };
+    uint64_t value[HW_NB] = {};
+    bool ok = false;
+
+    bool open(){
+#ifdef __linux__
+        static const uint64_t cfg[HW_NB] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+                                             PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_HW_CACHE_MISSES };
+        ok = true;
+        for(int i=0;i<HW_NB;i++){
+            perf_event_attr pe;
+            memset(&pe, 0, sizeof(pe));
+            pe.type = PERF_TYPE_HARDWARE;
+            pe.size = sizeof(pe);
+            pe.config = cfg[i];
+            pe.disabled = 1;
+            pe.exclude_kernel = 1;
+            pe.exclude_hv = 1;
+            fd[i] = (int)syscall(__NR_perf_event_open, &pe, 0, -1, -1, 0);
+            if(fd[i]<0) ok = false;
+        }
+        if(!ok) close();
+#endif
+        return ok;
+    }
+    void close(){
+#ifdef __linux__
+        for(int i=0;i<HW_NB;i++) if(fd[i]>=0){ ::close(fd[i]); fd[i]=-1; }
+#endif
+        ok = false;
+    }
+    void start(){
+#ifdef __linux__
+        if(!ok) return;
+        for(int i=0;i<HW_NB;i++){ ioctl(fd[i], PERF_EVENT_IOC_RESET, 0); ioctl(fd[i], PERF_EVENT_IOC_ENABLE, 0); }
+#endif
+    }
+    void stop(){
+#ifdef __linux__
+        if(!ok) return;
+        for(int i=0;i<HW_NB;i++){
+            ioctl(fd[i], PERF_EVENT_IOC_DISABLE, 0);
+            if(::read(fd[i], &value[i], sizeof(uint64_t))!=(ssize_t)sizeof(uint64_t)) value[i]=0;
+        }
+#endif
+    }
+    ~PerfCounters(){ close(); }
+};
+
+// ============ Medição ============
+struct BenchResult {
+    string name;
+    long long ops = 0;          // operações por amostra
+    double mean = 0, sd = 0, mn = 0; // ns/op
+    bool hw = false;
+    double hwPerOp[HW_NB] = {};
+};
+
+static const double SAMPLE_NS = 20e6; // ~20 ms por amostra
+
+// pass() roda uma passada sobre o corpus e devolve quantas operações fez.
+// Calibra repetições para cada amostra durar ~SAMPLE_NS; a variância é entre amostras.
+template<class F>
+static BenchResult measure(const string& name, int rounds, PerfCounters& perf, F pass){
+    using clk = chrono::steady_clock;
+    BenchResult r; r.name = name;
+    auto t0 = clk::now();
+    long long once = pass();
+    double t = (double)chrono::duration_cast<chrono::nanoseconds>(clk::now()-t0).count();
+    int reps = (int)max(1.0, SAMPLE_NS / max(t, 1.0));
+
+    vector<double> samples;
+    long long totalOps = 0;
+    perf.start();
+    for(int s=0; s<rounds; s++){
+        long long ops = 0;
+        auto a = clk::now();
+        for(int k=0; k<reps; k++) ops += pass();
+        double ns = (double)chrono::duration_cast<chrono::nanoseconds>(clk::now()-a).count();
+        samples.push_back(ns / max(1LL, ops));
+        totalOps += ops;
+    }
+    perf.stop();
+
+    r.ops = once * reps;
+    double sum=0; for(double x: samples) sum += x;
+    r.mean = sum / samples.size();
+    double var=0; for(double x: samples) var += (x-r.mean)*(x-r.mean);
+    r.sd = samples.size()>1? sqrt(var/(samples.size()-1)) : 0;
+    r.mn = *min_element(samples.begin(), samples.end());
+    if(perf.ok){
+        r.hw = true;
+        for(int i=0;i<HW_NB;i++) r.hwPerOp[i] = (double)perf.value[i] / max(1LL, totalOps);
+    }
+    return r;
+}
+
+int main(int argc, char** argv){
+    int rounds = 10, hashMB = 64;
+    bool json = false, usePerf = false;
+    string only;
+    for(int i=1;i<argc;i++){
+        string a = argv[i];
+        auto next=[&](){ return (i+1<argc)? string(argv[++i]) : string(); };
+        if(a=="--rounds") rounds = max(2, atoi(next().c_str()));
+        else if(a=="--json") json = true;
+        else if(a=="--perf") usePerf = true;
+        else if(a=="--only") only = next();
+        else if(a=="--hash") hashMB = max(1, atoi(next().c_str()));
+        else {
+            cerr << "usage: microbench [--rounds N] [--perf] [--json] [--only name] [--hash MB]" << endl;
+            return 1;
+        }
+    }
+
+    PerfCounters perf;
+    if(usePerf && !perf.open())
+        cerr << "perf_event_open unavailable (kernel.perf_event_paranoid?); timing only" << endl;
+
+    // Um engine por posição: nada de setFEN dentro do laço medido
+    vector<unique_ptr<DeepBeckyEngine>> pos;
+    vector<vector<Move>> legal;
+    for(int i=0;i<BENCH_FENS_NB;i++){
+        pos.push_back(make_unique<DeepBeckyEngine>(1));
+        pos.back()->setFEN(BENCH_FENS[i]);
+        legal.push_back(pos.back()->generateLegal());
+    }
+
+    // TT: chaves pseudo-aleatórias fixas, metade já gravada (probes com e sem acerto)
+    DeepBeckyEngine ttEngine(hashMB);
+    vector<uint64_t> keys(1<<16);
+    uint64_t x = 0x9E3779B97F4A7C15ULL;
+    for(auto& k: keys){ x ^= x<<13; x ^= x>>7; x ^= x<<17; k = x; }
+    for(size_t i=0;i<keys.size();i+=2){
+        TTEntry& te = ttEngine.tt[keys[i] & ttEngine.tt_mask];
+        te.key = keys[i]; te.depth = 1; te.flag = TT_EXACT; te.score = 0;
+    }
+
+    vector<pair<string, function<long long()>>> benches = {
+        {"generatePseudo", [&]{
+            long long n=0;
+            for(auto& e: pos){ g_sink += e->generatePseudo().size(); n++; }
+            return n; }},
+        {"generateLegal", [&]{
+            long long n=0;
+            for(auto& e: pos){ g_sink += e->generateLegal().size(); n++; }
+            return n; }},
+        {"makeMove+undoMove", [&]{
+            long long n=0;
+            for(size_t i=0;i<pos.size();i++){
+                DeepBeckyEngine& e = *pos[i];
+                for(const auto& m: legal[i]){ e.makeMove(m); g_sink += e.hash; e.undoMove(m); n++; }
+            }
+            return n; }},
+        {"isAttacked", [&]{
+            long long n=0;
+            for(auto& e: pos) for(int y=0;y<8;y++) for(int x2=0;x2<8;x2++){
+                g_sink += e->isAttacked(x2, y, true) + e->isAttacked(x2, y, false);
+                n += 2;
+            }
+            return n; }},
+        {"inCheck", [&]{
+            long long n=0;
+            for(auto& e: pos){ g_sink += e->inCheck(true) + e->inCheck(false); n += 2; }
+            return n; }},
+        {"evaluate", [&]{
+            long long n=0;
+            for(auto& e: pos){ g_sink += (uint64_t)e->evaluate(); n++; }
+            return n; }},
+        {"computeHash", [&]{
+            long long n=0;
+            for(auto& e: pos){ g_sink += e->computeHash(); n++; }
+            return n; }},
+        {"ttProbe", [&]{
+            TTEntry* tt = ttEngine.tt; size_t mask = ttEngine.tt_mask;
+            uint64_t s=0;
+            for(uint64_t k: keys){ const TTEntry& te = tt[k & mask]; if(te.key==k) s += te.score + 1; }
+            g_sink += s;
+            return (long long)keys.size(); }},
+        {"ttStore", [&]{
+            TTEntry* tt = ttEngine.tt; size_t mask = ttEngine.tt_mask;
+            for(uint64_t k: keys){
+                TTEntry& te = tt[k & mask];
+                te.key = k; te.depth = 4; te.flag = TT_BETA; te.score = (int16_t)(k & 255); te.best = MOVE_NONE;
+            }
+            return (long long)keys.size(); }},
+    };
+
+    vector<BenchResult> results;
+    for(auto& b: benches){
+        if(!only.empty() && b.first!=only) continue;
+        results.push_back(measure(b.first, rounds, perf, b.second));
+    }
+
+    if(json){
+        cout << "{\"engine\":\"" << ENGINE_NAME << " " << ENGINE_VERSION << "\",\"rounds\":" << rounds
+             << ",\"positions\":" << BENCH_FENS_NB << ",\"results\":[";
+        for(size_t i=0;i<results.size();i++){
+            const auto& r = results[i];
+            cout << (i? ",":"") << "{\"name\":\"" << r.name << "\",\"ops\":" << r.ops
+                 << ",\"ns_per_op\":" << r.mean << ",\"stddev\":" << r.sd << ",\"min\":" << r.mn;
+            if(r.hw) for(int k=0;k<HW_NB;k++) cout << ",\"" << HW_NAME[k] << "_per_op\":" << r.hwPerOp[k];
+            cout << "}";
+        }
+        cout << "]}" << endl;
+        return 0;
+    }
+
+    cout << ENGINE_NAME << " " << ENGINE_VERSION << " microbench, " << BENCH_FENS_NB << " positions, "
+         << rounds << " rounds" << endl;
+    char line[256];
+    snprintf(line, sizeof(line), "%-18s %10s %9s %10s", "benchmark", "ns/op", "+-sd", "min");
+    cout << line;
+    if(perf.ok) cout << "   cycles/op    instr/op   IPC  br-miss/op  cache-miss/op";
+    cout << endl;
+    for(const auto& r: results){
+        snprintf(line, sizeof(line), "%-18s %10.2f %9.2f %10.2f", r.name.c_str(), r.mean, r.sd, r.mn);
+        cout << line;
+        if(r.hw){
+            double c=r.hwPerOp[0], in=r.hwPerOp[1];
+            snprintf(line, sizeof(line), " %11.1f %11.1f %5.2f %11.3f %14.3f", c, in, c>0? in/c : 0.0, r.hwPerOp[2], r.hwPerOp[3]);
+            cout << line;
+        }
+        cout << endl;
+    }
+    return 0;
+}
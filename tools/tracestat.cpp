@@ -0,0 +1,170 @@
+/*
+ * Deep Becky 0.2 - UCI Chess Engine
+ * Copyright (C) 2025-2026 Diogo de Oliveira Almeida
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ */
+
+// tracestat: resume um arquivo gravado com "setoption name TraceFile".
+// Lê em streaming (arquivos de GB ficam ok) e mostra: nós por tipo e motivo
+// de saída, janelas de aspiração da raiz, nós/branching por ply, maiores
+// subárvores e os nós pior ordenados (corte beta tardio com subárvore grande).
+//
+// Compilar: g++ -O2 -std=c++17 -pthread -I. tools/tracestat.cpp -o tracestat
+// Uso:      tracestat trace.bin [--top N]
+
+#include "engine.h"
+#include <queue>
+
+static const char* REASON_NAME[TR_NB] = {
+    "none", "beta", "tt", "rfp", "nmp", "mate-dist",
+    "stand-pat", "draw", "mate", "stalemate", "horizon", "stop",
+    "fail-low", "fail-high", "bitbase"
+};
+static const char* KIND_NAME[3] = { "pvs", "qsearch", "root" };
+
+// Mantém os N maiores por chave
+struct TopN {
+    size_t n;
+    priority_queue<pair<uint64_t,TraceRecord>, vector<pair<uint64_t,TraceRecord>>,
+                   function<bool(const pair<uint64_t,TraceRecord>&, const pair<uint64_t,TraceRecord>&)>> q;
+    explicit TopN(size_t n_) : n(n_), q([](const pair<uint64_t,TraceRecord>& a, const pair<uint64_t,TraceRecord>& b){ return a.first > b.first; }) {}
+    void add(uint64_t key, const TraceRecord& r){
+        if(q.size()<n){ q.push({key, r}); return; }
+        if(key > q.top().first){ q.pop(); q.push({key, r}); }
+    }
+    vector<pair<uint64_t,TraceRecord>> sorted(){
+        vector<pair<uint64_t,TraceRecord>> v;
+        while(!q.empty()){ v.push_back(q.top()); q.pop(); }
+        reverse(v.begin(), v.end());
+        return v;
+    }
+};
+
+static void printNode(uint64_t key, const TraceRecord& r){
+    char line[256];
+    snprintf(line, sizeof(line), "  %10llu  %-7s ply %2d depth %2d  [%6d,%6d] -> %6d  %-9s move %-5s idx %3d/%-3d hash %016llx",
+             (unsigned long long)key, KIND_NAME[min<int>(r.kind,2)], r.ply, r.depth, r.alpha, r.beta, r.result,
+             REASON_NAME[min<int>(r.reason, TR_NB-1)], packedToUCI(r.move).c_str(), r.idx, r.nmoves,
+             (unsigned long long)r.hash);
+    cout << line << '\n';
+}
+
+int main(int argc, char** argv){
+    string path; size_t top = 10;
+    for(int i=1;i<argc;i++){
+        string a = argv[i];
+        if(a=="--top" && i+1<argc) top = (size_t)max(1, atoi(argv[++i]));
+        else path = a;
+    }
+    if(path.empty()){ cerr << "usage: tracestat trace.bin [--top N]" << endl; return 1; }
+    ifstream in(path, ios::binary);
+    if(!in){ cerr << "cannot open " << path << endl; return 1; }
+    TraceHeader h{};
+    if(!in.read((char*)&h, sizeof(h)) || memcmp(h.magic, TRACE_MAGIC, sizeof(h.magic))!=0
+       || h.version!=1 || h.record_size!=sizeof(TraceRecord)){
+        cerr << path << ": not a version 1 trace file" << endl;
+        return 1;
+    }
+
+    long long kinds[3] = {}, reasons[3][TR_NB] = {};
+    vector<long long> plyNodes[2], plySubtree[2];
+    for(auto& v: plyNodes) v.assign(MAX_PLY+1, 0);
+    for(auto& v: plySubtree) v.assign(MAX_PLY+1, 0);
+    vector<long long> cutIdx(257, 0);
+    struct RootDepth { long long calls=0, failLow=0, failHigh=0, nodes=0, wasted=0; };
+    map<int, RootDepth> roots;
+    TopN bigPvs(top), bigQs(top), worst(top);
+    long long total = 0;
+
+    vector<TraceRecord> buf(1<<16);
+    for(;;){
+        in.read((char*)buf.data(), buf.size()*sizeof(TraceRecord));
+        size_t n = (size_t)in.gcount() / sizeof(TraceRecord);
+        if(!n) break;
+        for(size_t i=0;i<n;i++){
+            const TraceRecord& r = buf[i];
+            int k = min<int>(r.kind, 2), reason = min<int>(r.reason, TR_NB-1);
+            kinds[k]++; reasons[k][reason]++; total++;
+            if(k==TK_ROOT){
+                RootDepth& rd = roots[r.depth];
+                rd.calls++; rd.nodes += r.subtree;
+                if(reason==TR_FAIL_LOW){ rd.failLow++; rd.wasted += r.subtree; }
+                if(reason==TR_FAIL_HIGH){ rd.failHigh++; rd.wasted += r.subtree; }
+                continue;
+            }
+            int ply = min<int>(r.ply, MAX_PLY);
+            plyNodes[k][ply]++; plySubtree[k][ply] += r.subtree;
+            if(k==TK_PVS){
+                bigPvs.add(r.subtree, r);
+                if(reason==TR_BETA){
+                    cutIdx[r.idx]++;
+                    if(r.idx>1) worst.add((uint64_t)r.subtree * (r.idx-1) / max<int>(1, r.idx), r);
+                }
+            }else{
+                bigQs.add(r.subtree, r);
+            }
+        }
+        if(n < buf.size()) break;
+    }
+
+    cout << path << ": " << total << " records (pvs " << kinds[0] << ", qsearch " << kinds[1]
+         << ", root " << kinds[2] << ")\n\n";
+
+    cout << "exit reasons\n";
+    for(int k=0;k<3;k++){
+        if(!kinds[k]) continue;
+        cout << "  " << KIND_NAME[k] << ":";
+        for(int r=0;r<TR_NB;r++) if(reasons[k][r])
+            cout << ' ' << REASON_NAME[r] << ' ' << fixed << setprecision(1) << 100.0*reasons[k][r]/kinds[k] << "%";
+        cout << '\n';
+    }
+
+    long long cuts=0; for(long long c: cutIdx) cuts += c;
+    if(cuts){
+        cout << "\nbeta cutoffs by move index (pvs)\n ";
+        long long rest=0;
+        for(int i=1;i<(int)cutIdx.size();i++){
+            if(i<=8) cout << ' ' << i << ':' << 100.0*cutIdx[i]/cuts << "%";
+            else rest += cutIdx[i];
+        }
+        cout << " 9+:" << 100.0*rest/cuts << "%\n";
+    }
+
+    if(!roots.empty()){
+        cout << "\nroot (aspiration windows)\n  depth  calls  fail-low  fail-high      nodes  wasted\n";
+        for(auto& [d, rd]: roots){
+            char line[160];
+            snprintf(line, sizeof(line), "  %5d %6lld %9lld %10lld %10lld  %5.1f%%", d, rd.calls, rd.failLow, rd.failHigh,
+                     rd.nodes, rd.nodes? 100.0*rd.wasted/rd.nodes : 0.0);
+            cout << line << '\n';
+        }
+    }
+
+    cout << "\nper ply\n    ply        pvs    qsearch   branching  avg-subtree\n";
+    for(int p=0;p<=MAX_PLY;p++){
+        long long here = plyNodes[0][p] + plyNodes[1][p];
+        if(!here) continue;
+        long long next = p<MAX_PLY? plyNodes[0][p+1] + plyNodes[1][p+1] : 0;
+        char line[160];
+        snprintf(line, sizeof(line), "  %5d %10lld %10lld %11.2f %12.1f", p, plyNodes[0][p], plyNodes[1][p],
+                 (double)next/here, (double)(plySubtree[0][p]+plySubtree[1][p])/here);
+        cout << line << '\n';
+    }
+
+    cout << "\nlargest pvs subtrees (nodes)\n";
+    for(auto& [k, r]: bigPvs.sorted()) printNode(k, r);
+    cout << "\nlargest qsearch subtrees (nodes)\n";
+    for(auto& [k, r]: bigQs.sorted()) printNode(k, r);
+    cout << "\nworst-ordered nodes (late beta cutoff, est. wasted nodes)\n";
+    for(auto& [k, r]: worst.sorted()) printNode(k, r);
+    return 0;
+}
@@ -0,0 +1,305 @@
+/*
+ * Deep Becky 0.2 - UCI Chess Engine
+ * Copyright (C) 2025-2026 Diogo de Oliveira Almeida
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ */
+
+// ============ Tuner (Texel) ============
+// deepbecky tune --data positions.epd [--threads T] [--epochs N] [--lr x] [--k K] [--out eval_params.h]
+//
+// Cada linha: FEN (4 ou 6 campos) seguido do resultado da partida em
+// qualquer formato comum: "1-0" / "0-1" / "1/2-1/2", [1.0] / [0.5] / [0.0]
+// ou c9 "1-0";. Arquivos .bin são lidos como PackedPos (saída do gensfen).
+// A avaliação é linear nos parâmetros, então cada posição vira uma lista
+// curta de (peça, casa) + termos de mobilidade/par de bispos e o erro
+// sigmoide é minimizado com gradiente exato (Adam), somado em paralelo.
+#include "engine.h"
+
+namespace {
+
+// Posição compacta: 8 bytes + 2 por peça (tipo|cor|casa)
+struct TunePos {
+    uint32_t first;      // índice em pieces
+    uint8_t  count;
+    int8_t   mobility;   // casas livres de torre/dama, brancas - pretas
+    int8_t   bishopPair; // +1 / 0 / -1
+    uint8_t  result;     // 0 derrota, 1 empate, 2 vitória (brancas)
+};
+
+struct TuneSet {
+    vector<TunePos> pos;
+    vector<uint16_t> pieces; // t (0..5) | preta<<3 | casa<<4
+};
+
+bool parseResult(const string& rest, int& r){
+    static const pair<const char*,int> TOK[] = {
+        {"1/2-1/2",1}, {"1-0",2}, {"0-1",0}, {"[0.5]",1}, {"[1.0]",2}, {"[0.0]",0}, {"[1]",2}, {"[0]",0}
+    };
+    for(const auto& t: TOK) if(rest.find(t.first)!=string::npos){ r=t.second; return true; }
+    // Número solto: só o último token, e nunca um dos relógios de uma FEN de 6 campos
+    stringstream ss(rest);
+    vector<string> tok;
+    for(string t; ss>>t; ) tok.push_back(t);
+    auto isInt=[](const string& t){ return !t.empty() && all_of(t.begin(), t.end(), ::isdigit); };
+    size_t first = tok.size()>=2 && isInt(tok[0]) && isInt(tok[1]) ? 2 : 0;
+    if(tok.size()<=first) return false;
+    const string& last = tok.back();
+    if(last=="0" || last=="0.0"){ r=0; return true; }
+    if(last=="0.5"){ r=1; return true; }
+    if(last=="1" || last=="1.0"){ r=2; return true; }
+    return false;
+}
+
+// Tabuleiro atual do engine -> posição compacta, com os mesmos termos de evaluate()
+void encodeBoard(const DeepBeckyEngine& e, int result, TuneSet& set){
+    TunePos tp{};
+    tp.first = (uint32_t)set.pieces.size();
+    tp.result = (uint8_t)result;
+    int bW=0, bB=0, mob=0;
+    for(int y=0;y<8;y++) for(int x=0;x<8;x++){
+        int p=e.b[y][x]; if(!p) continue;
+        bool black = isBlackPiece(p);
+        int t = black? p-BPAWN : p-WPAWN;
+        set.pieces.push_back((uint16_t)(t | (black? 8:0) | sq(x,y)<<4));
+        tp.count++;
+        if(p==WBISHOP) bW++;
+        if(p==BBISHOP) bB++;
+        if(t==WROOK-WPAWN || t==WQUEEN-WPAWN){
+            static const int D[4][2]={{1,0},{-1,0},{0,1},{0,-1}};
+            int c=0;
+            for(auto& d: D){
+                int nx=x+d[0], ny=y+d[1];
+                while(onBoard(nx,ny) && e.b[ny][nx]==EMPTY){ c++; nx+=d[0]; ny+=d[1]; }
+            }
+            mob += black? -c : c;
+        }
+    }
+    tp.mobility = (int8_t)max(-127, min(127, mob));
+    tp.bishopPair = (int8_t)((bW>=2) - (bB>=2));
+    set.pos.push_back(tp);
+}
+
+bool encodeLine(DeepBeckyEngine& e, const string& line, TuneSet& set){
+    stringstream ss(line);
+    string f[4];
+    for(auto& x: f) if(!(ss>>x)) return false;
+    string fen = f[0]+" "+f[1]+" "+f[2]+" "+f[3];
+    string rest; getline(ss, rest);
+    int result;
+    if(!parseResult(rest, result)) return false;
+    e.setFEN(fen + " 0 1");
+    encodeBoard(e, result, set);
+    return true;
+}
+
+// Avaliação (brancas) e, se grad!=nullptr, acumula coef*escala no gradiente
+inline double evalPos(const TuneSet& s, const TunePos& p, const vector<double>& w, double* grad, double scale){
+    double v = 0;
+    for(uint32_t i=p.first; i<p.first+p.count; i++){
+        uint16_t pc = s.pieces[i];
+        int t = pc&7, sqi = pc>>4;
+        bool black = pc&8;
+        double sg = black? -1.0 : 1.0;
+        int r = black? 56^sqi : sqi;
+        if(t==5){
+            int mg = EP_PST+PST_KMG*64+r, eg = EP_PST+PST_KEG*64+r;
+            v += sg*0.5*(w[mg]+w[eg]);
+            if(grad){ grad[mg] += sg*0.5*scale; grad[eg] += sg*0.5*scale; }
+        }else{
+            int m = EP_MATERIAL+t, ps = EP_PST+t*64+r;
+            v += sg*(w[m]+w[ps]);
+            if(grad){ grad[m] += sg*scale; grad[ps] += sg*scale; }
+        }
+    }
+    v += p.bishopPair*w[EP_BISHOP_PAIR] + p.mobility*w[EP_MOBILITY];
+    if(grad){ grad[EP_BISHOP_PAIR] += p.bishopPair*scale; grad[EP_MOBILITY] += p.mobility*scale; }
+    return v;
+}
+
+inline double sigmoid(double k, double e){ return 1.0/(1.0+pow(10.0, -k*e/400.0)); }
+
+// Roda f(início, fim, thread) em T fatias do conjunto
+template<class F>
+void parallelFor(size_t n, int threads, F f){
+    vector<thread> pool;
+    size_t chunk = (n+threads-1)/threads;
+    for(int t=0;t<threads;t++){
+        size_t a=t*chunk, b=min(n, a+chunk);
+        if(a>=b) break;
+        pool.emplace_back(f, a, b, t);
+    }
+    for(auto& th: pool) th.join();
+}
+
+double meanError(const TuneSet& s, const vector<double>& w, double k, int threads){
+    vector<double> part(threads, 0.0);
+    parallelFor(s.pos.size(), threads, [&](size_t a, size_t b, int t){
+        double e=0;
+        for(size_t i=a;i<b;i++){
+            double d = s.pos[i].result*0.5 - sigmoid(k, evalPos(s, s.pos[i], w, nullptr, 0));
+            e += d*d;
+        }
+        part[t]=e;
+    });
+    double e=0; for(double x: part) e+=x;
+    return e / max<size_t>(1, s.pos.size());
+}
+
+// K que melhor casa a escala atual com os resultados (seção áurea)
+double fitK(const TuneSet& s, const vector<double>& w, int threads){
+    double a=0.1, b=3.0, g=(sqrt(5.0)-1)/2;
+    double c=b-g*(b-a), d=a+g*(b-a);
+    double fc=meanError(s,w,c,threads), fd=meanError(s,w,d,threads);
+    for(int i=0;i<40;i++){
+        if(fc<fd){ b=d; d=c; fd=fc; c=b-g*(b-a); fc=meanError(s,w,c,threads); }
+        else     { a=c; c=d; fc=fd; d=a+g*(b-a); fd=meanError(s,w,d,threads); }
+    }
+    return (a+b)/2;
+}
+
+void writeHeader(ostream& o, const EvalParams& p, const string& comment){
+    static const char* LABEL[PST_NB] = { "peão", "cavalo", "bispo", "torre", "dama", "rei (meio-jogo)", "rei (final)" };
+    o << "/*\n"
+         " * Deep Becky 0.2 - UCI Chess Engine\n"
+         " * Copyright (C) 2025-2026 Diogo de Oliveira Almeida\n"
+         " *\n"
+         " * This program is free software: you can redistribute it and/or modify\n"
+         " * it under the terms of the GNU General Public License as published by\n"
+         " * the Free Software Foundation, either version 3 of the License, or\n"
+         " * (at your option) any later version.\n"
+         " *\n"
+         " * This program is distributed in the hope that it will be useful,\n"
+         " * but WITHOUT ANY WARRANTY; without even the implied warranty of\n"
+         " * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the\n"
+         " * GNU General Public License for more details.\n"
+         " */\n\n"
+         "// Pesos da avaliação em centipeões, lidos por evaluate() via EvalParams.\n"
+         "// Gerado por \"deepbecky tune\" (--out) e pode ser substituído pela saída dele.\n"
+         "// PSTs do ponto de vista das brancas, a1..h8 (primeira linha = fileira 1);\n"
+         "// as pretas usam a casa espelhada.\n";
+    if(!comment.empty()) o << "// " << comment << "\n";
+    o << "#ifndef DEEPBECKY_EVAL_PARAMS_H\n#define DEEPBECKY_EVAL_PARAMS_H\n\n";
+    o << "static const int EVAL_MATERIAL[5] = { ";
+    for(int t=0;t<5;t++) o << (t? ", ":"") << p.material(t);
+    o << " }; // P N B R Q\n\nstatic const int EVAL_PST[7][64] = {\n";
+    char cell[16];
+    for(int t=0;t<PST_NB;t++){
+        o << "    { // " << LABEL[t] << "\n";
+        for(int r=0;r<8;r++){
+            o << "        ";
+            for(int f=0;f<8;f++){ snprintf(cell, sizeof(cell), "%4d,", p.pst(t, r*8+f)); o << cell; }
+            o << "\n";
+        }
+        o << "    },\n";
+    }
+    o << "};\n\n"
+      << "static const int EVAL_BISHOP_PAIR = " << p.v[EP_BISHOP_PAIR] << ";\n"
+      << "static const int EVAL_MOBILITY    = " << p.v[EP_MOBILITY] << "; // por casa livre de torre/dama na horizontal/vertical\n\n"
+      << "#endif // DEEPBECKY_EVAL_PARAMS_H\n";
+}
+
+} // namespace
+
+int runTune(int argc, char** argv){
+    string dataPath, outPath;
+    int threads = max(1u, thread::hardware_concurrency());
+    int epochs = 300;
+    double lr = 1.0, k = 0;
+    for(int i=2;i<argc;i++){
+        string a=argv[i];
+        auto next=[&](){ return (i+1<argc)? string(argv[++i]) : string(); };
+        if(a=="--data") dataPath=next();
+        else if(a=="--out") outPath=next();
+        else if(a=="--threads") threads=atoi(next().c_str());
+        else if(a=="--epochs") epochs=atoi(next().c_str());
+        else if(a=="--lr") lr=atof(next().c_str());
+        else if(a=="--k") k=atof(next().c_str());
+    }
+    if(dataPath.empty()){
+        cerr << "usage: deepbecky tune --data positions.epd [--threads T] [--epochs N] [--lr x] [--k K] [--out eval_params.h]" << endl;
+        return 1;
+    }
+    threads = max(1, min(threads, 256));
+
+    bool packed = dataPath.size()>4 && dataPath.compare(dataPath.size()-4, 4, ".bin")==0;
+    ifstream in;
+    SfenReader reader;
+    if(packed? !reader.open(dataPath) : (in.open(dataPath), !in)){ cerr << "cannot open " << dataPath << endl; return 1; }
+    auto t0 = chrono::high_resolution_clock::now();
+    TuneSet set;
+    {
+        DeepBeckyEngine e(1);
+        string line; long long skipped=0;
+        PackedPos pp;
+        if(packed) while(reader.next(pp)){
+            e.unpack(pp);
+            int white = (pp.flags&1)? -pp.result : pp.result;
+            encodeBoard(e, white+1, set);
+        }
+        else while(getline(in, line)) if(!line.empty() && !encodeLine(e, line, set)) skipped++;
+        set.pos.shrink_to_fit(); set.pieces.shrink_to_fit();
+        cerr << "loaded " << set.pos.size() << " positions (" << skipped << " skipped, "
+             << (set.pos.size()*sizeof(TunePos) + set.pieces.size()*sizeof(uint16_t))/1024 << " KB) in "
+             << chrono::duration_cast<chrono::milliseconds>(chrono::high_resolution_clock::now()-t0).count() << " ms" << endl;
+    }
+    if(set.pos.empty()){ cerr << "no labelled positions" << endl; return 1; }
+
+    vector<double> w(EP_NB);
+    for(int i=0;i<EP_NB;i++) w[i] = EVAL_DEFAULT.v[i];
+    if(k<=0) k = fitK(set, w, threads);
+    double err0 = meanError(set, w, k, threads);
+    cerr << "K = " << k << ", initial error " << setprecision(8) << err0 << endl;
+
+    // Adam sobre o gradiente exato do erro médio
+    const double B1=0.9, B2=0.999, EPS=1e-8;
+    vector<double> m(EP_NB, 0.0), v(EP_NB, 0.0);
+    vector<vector<double>> grads(threads, vector<double>(EP_NB));
+    double ln10k = log(10.0)*k/400.0;
+    size_t n = set.pos.size();
+    for(int ep=1; ep<=epochs; ep++){
+        parallelFor(n, threads, [&](size_t a, size_t b, int t){
+            vector<double>& g = grads[t];
+            fill(g.begin(), g.end(), 0.0);
+            for(size_t i=a;i<b;i++){
+                const TunePos& p = set.pos[i];
+                double s = sigmoid(k, evalPos(set, p, w, nullptr, 0));
+                double scale = -2.0*(p.result*0.5 - s)*s*(1-s)*ln10k;
+                evalPos(set, p, w, g.data(), scale);
+            }
+        });
+        for(int j=0;j<EP_NB;j++){
+            double g=0; for(int t=0;t<threads;t++) g += grads[t][j];
+            g /= n;
+            m[j] = B1*m[j] + (1-B1)*g;
+            v[j] = B2*v[j] + (1-B2)*g*g;
+            double mh = m[j]/(1-pow(B1,ep)), vh = v[j]/(1-pow(B2,ep));
+            w[j] -= lr*mh/(sqrt(vh)+EPS);
+        }
+        if(ep%25==0 || ep==epochs)
+            cerr << "epoch " << ep << " error " << meanError(set, w, k, threads) << endl;
+    }
+
+    EvalParams tuned;
+    for(int i=0;i<EP_NB;i++) tuned.v[i] = (int)lround(w[i]);
+    double err1 = meanError(set, w, k, threads);
+    stringstream note;
+    note << "tune: " << set.pos.size() << " positions, " << epochs << " epochs, K " << setprecision(4) << k
+         << ", error " << setprecision(6) << err0 << " -> " << err1;
+    if(outPath.empty()) writeHeader(cout, tuned, note.str());
+    else{
+        ofstream out(outPath);
+        if(!out){ cerr << "cannot write " << outPath << endl; return 1; }
+        writeHeader(out, tuned, note.str());
+        cerr << "wrote " << outPath << endl;
+    }
+    return 0;
+}